@@ -95,22 +95,30 @@ SOURCES += \
     src/application.cpp \
     src/channel.cpp \
     src/channeldata.cpp \
+    src/messages/highlightmatcher.cpp \
     src/messages/image.cpp \
+    src/messages/imagedecoder.cpp \
+    src/messages/layouts/animationscheduler.cpp \
     src/messages/layouts/messagelayout.cpp \
     src/messages/layouts/messagelayoutcontainer.cpp \
     src/messages/layouts/messagelayoutelement.cpp \
+    src/messages/layouts/messagelayoutengine.cpp \
+    src/messages/layouts/pixmappool.cpp \
     src/messages/link.cpp \
     src/messages/message.cpp \
     src/messages/messagebuilder.cpp \
     src/messages/messagecolor.cpp \
     src/messages/messageelement.cpp \
+    src/messages/searchindex.cpp \
     src/providers/irc/abstractircserver.cpp \
     src/providers/twitch/ircmessagehandler.cpp \
     src/providers/twitch/twitchaccount.cpp \
     src/providers/twitch/twitchaccountmanager.cpp \
     src/providers/twitch/twitchchannel.cpp \
     src/providers/twitch/twitchmessagebuilder.cpp \
+    src/providers/twitch/twitchmessagepipeline.cpp \
     src/providers/twitch/twitchserver.cpp \
+    src/providers/twitch/twitchtags.cpp \
     src/singletons/accountmanager.cpp \
     src/singletons/channelmanager.cpp \
     src/singletons/commandmanager.cpp \
@@ -118,15 +126,18 @@ SOURCES += \
     src/singletons/fontmanager.cpp \
     src/util/completionmodel.cpp \
     src/singletons/helper/loggingchannel.cpp \
+    src/singletons/helper/logindex.cpp \
     src/singletons/helper/moderationaction.cpp \
     src/singletons/loggingmanager.cpp \
     src/singletons/pathmanager.cpp \
     src/singletons/resourcemanager.cpp \
+    src/singletons/scrollbackmanager.cpp \
     src/singletons/settingsmanager.cpp \
     src/singletons/thememanager.cpp \
     src/singletons/windowmanager.cpp \
     src/util/networkmanager.cpp \
     src/util/networkrequest.cpp \
+    src/util/stringinterner.cpp \
     src/widgets/accountpopup.cpp \
     src/widgets/accountswitchpopupwidget.cpp \
     src/widgets/accountswitchwidget.cpp \
@@ -184,11 +195,16 @@ HEADERS  += \
     src/const.hpp \
     src/debug/log.hpp \
     src/emojis.hpp \
+    src/messages/highlightmatcher.hpp \
     src/messages/highlightphrase.hpp \
     src/messages/image.hpp \
+    src/messages/imagedecoder.hpp \
+    src/messages/layouts/animationscheduler.hpp \
     src/messages/layouts/messagelayout.hpp \
     src/messages/layouts/messagelayoutcontainer.hpp \
     src/messages/layouts/messagelayoutelement.hpp \
+    src/messages/layouts/messagelayoutengine.hpp \
+    src/messages/layouts/pixmappool.hpp \
     src/messages/limitedqueue.hpp \
     src/messages/limitedqueuesnapshot.hpp \
     src/messages/link.hpp \
@@ -197,14 +213,19 @@ HEADERS  += \
     src/messages/messagecolor.hpp \
     src/messages/messageelement.hpp \
     src/messages/messageparseargs.hpp \
+    src/messages/positionlist.hpp \
+    src/messages/searchindex.hpp \
     src/messages/selection.hpp \
     src/providers/twitch/emotevalue.hpp \
+    src/providers/twitch/firehosefilter.hpp \
     src/providers/twitch/ircmessagehandler.hpp \
     src/providers/twitch/twitchaccount.hpp \
     src/providers/twitch/twitchaccountmanager.hpp \
     src/providers/twitch/twitchchannel.hpp \
     src/providers/twitch/twitchmessagebuilder.hpp \
+    src/providers/twitch/twitchmessagepipeline.hpp \
     src/providers/twitch/twitchserver.hpp \
+    src/providers/twitch/twitchtags.hpp \
     src/singletons/accountmanager.hpp \
     src/singletons/channelmanager.hpp \
     src/singletons/commandmanager.hpp \
@@ -213,14 +234,17 @@ HEADERS  += \
     src/singletons/helper/chatterinosetting.hpp \
     src/util/completionmodel.hpp \
     src/singletons/helper/loggingchannel.hpp \
+    src/singletons/helper/logindex.hpp \
     src/singletons/helper/moderationaction.hpp \
     src/singletons/loggingmanager.hpp \
     src/singletons/pathmanager.hpp \
     src/singletons/resourcemanager.hpp \
+    src/singletons/scrollbackmanager.hpp \
     src/singletons/settingsmanager.hpp \
     src/singletons/thememanager.hpp \
     src/singletons/windowmanager.hpp \
     src/util/benchmark.hpp \
+    src/util/arena.hpp \
     src/util/concurrentmap.hpp \
     src/util/distancebetweenpoints.hpp \
     src/util/emotemap.hpp \
@@ -236,7 +260,9 @@ HEADERS  += \
     src/util/posttothread.hpp \
     src/util/property.hpp \
     src/util/serialize-custom.hpp \
+    src/util/stringinterner.hpp \
     src/util/urlfetch.hpp \
+    src/util/wordwrap.hpp \
     src/widgets/accountpopup.hpp \
     src/widgets/accountswitchpopupwidget.hpp \
     src/widgets/accountswitchwidget.hpp \
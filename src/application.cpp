@@ -4,6 +4,7 @@
 #include "singletons/commandmanager.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/loggingmanager.hpp"
+#include "singletons/scrollbackmanager.hpp"
 #include "singletons/settingsmanager.hpp"
 #include "singletons/thememanager.hpp"
 #include "singletons/windowmanager.hpp"
@@ -19,10 +20,11 @@ Application::Application()
 {
     singletons::WindowManager::getInstance();
 
-    singletons::LoggingManager::getInstance();
+    singletons::LoggingManager::getInstance().indexLogs();
 
     singletons::SettingManager::getInstance().init();
     singletons::CommandManager::getInstance().loadCommands();
+    singletons::ScrollbackManager::getInstance();
 
     singletons::WindowManager::getInstance().initMainWindow();
 
@@ -4,6 +4,7 @@
 #include "singletons/emotemanager.hpp"
 #include "singletons/ircmanager.hpp"
 #include "singletons/loggingmanager.hpp"
+#include "singletons/scrollbackmanager.hpp"
 #include "singletons/windowmanager.hpp"
 
 #include <QJsonArray>
@@ -14,18 +15,37 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 
+#include <algorithm>
+
 using namespace chatterino::messages;
 
 namespace chatterino {
 
-Channel::Channel(const QString &_name)
+namespace {
+
+// rough size of an entry of a hash or map of an index, without the positions
+const size_t INDEX_ENTRY_SIZE = 64;
+
+}  // namespace
+
+Channel::Channel(const QString &_name, bool _indexed)
     : name(_name)
     , completionModel(this->name)
+    , indexed(_indexed)
 {
+    this->appendTimer.setInterval(1000 / 60);
+    this->appendTimer.setSingleShot(true);
+    QObject::connect(&this->appendTimer, &QTimer::timeout, [this] {
+        this->flushAppendedMessages();  //
+    });
 }
 
 Channel::~Channel()
 {
+    if (this->usesScrollbackBudget) {
+        singletons::ScrollbackManager::getInstance().removeChannel(this);
+    }
+
     this->destroyed.invoke();
 }
 
@@ -52,29 +72,308 @@ void Channel::addMessage(MessagePtr message)
 
     singletons::LoggingManager::getInstance().addMessage(this->name, message);
 
-    if (this->messages.pushBack(message, deleted)) {
-        this->messageRemovedFromStart(deleted);
+    this->messagesMemoryUsage += message->getEstimatedSize();
+
+    bool removed = this->messages.pushBack(message, deleted);
+
+    this->indexMessage(message, this->messages.getEndPosition() - 1, true);
+
+    this->appendedMessages.push_back(message);
+
+    if (removed) {
+        // the removed message was right in front of the new first message
+        this->onMessageRemoved(deleted, this->messages.getFirstPosition() - 1);
+
+        this->queueRemovedAtStart(1);
     }
 
-    this->messageAppended(message);
+    if (!this->appendTimer.isActive()) {
+        this->appendTimer.start();
+    }
 }
 
 void Channel::addMessagesAtStart(std::vector<messages::MessagePtr> &_messages)
 {
     std::vector<messages::MessagePtr> addedMessages = this->messages.pushFront(_messages);
 
+    size_t position = this->messages.getFirstPosition();
+
+    for (const messages::MessagePtr &message : addedMessages) {
+        this->messagesMemoryUsage += message->getEstimatedSize();
+
+        // messages that are already in the channel keep their newer position
+        this->indexMessage(message, position++, false);
+    }
+
     if (addedMessages.size() != 0) {
+        this->flushAppendedMessages();
         this->messagesAddedAtStart(addedMessages);
     }
 }
 
 void Channel::replaceMessage(messages::MessagePtr message, messages::MessagePtr replacement)
 {
-    int index = this->messages.replaceItem(message, replacement);
+    auto it = this->positionsByPointer.find(message.get());
+
+    if (it == this->positionsByPointer.end()) {
+        return;
+    }
+
+    size_t position = it->second;
+    size_t index = position - this->messages.getFirstPosition();
+
+    if (!this->messages.replaceItem(index, replacement)) {
+        return;
+    }
+
+    this->unindexMessage(message, position);
+    this->indexMessage(replacement, position, true);
+
+    this->messagesMemoryUsage += replacement->getEstimatedSize();
+    this->messagesMemoryUsage -= message->getEstimatedSize();
+
+    this->flushAppendedMessages();
+    this->messageReplaced(index, replacement);
+}
+
+messages::MessagePtr Channel::findMessage(const QString &messageId)
+{
+    auto it = this->positionsById.find(messageId);
+
+    if (it == this->positionsById.end()) {
+        return nullptr;
+    }
+
+    return this->getMessageAt(it.value());
+}
+
+std::vector<messages::MessagePtr> Channel::getMessagesFromUser(const QString &loginName)
+{
+    std::vector<messages::MessagePtr> userMessages;
+
+    auto it = this->positionsByLoginName.find(loginName);
+
+    if (it == this->positionsByLoginName.end()) {
+        return userMessages;
+    }
+
+    auto snapshot = this->messages.getSnapshot();
+    size_t firstPosition = this->messages.getFirstPosition();
+
+    userMessages.reserve(it.value().size());
+
+    for (size_t position : it.value()) {
+        userMessages.push_back(snapshot[position - firstPosition]);
+    }
+
+    return userMessages;
+}
+
+std::vector<messages::MessagePtr> Channel::search(const QString &text)
+{
+    std::vector<messages::MessagePtr> results;
+
+    SearchQuery query = SearchQuery::parse(text);
+
+    auto snapshot = this->messages.getSnapshot();
+    size_t firstPosition = this->messages.getFirstPosition();
+
+    if (query.isEmpty()) {
+        results.assign(snapshot.begin(), snapshot.end());
+        return results;
+    }
+
+    // positions of the messages that match all parts of the query so far
+    std::vector<size_t> positions;
+    bool restricted = false;
+
+    auto restrict = [&](std::vector<size_t> matches) {
+        if (restricted) {
+            intersectPositions(positions, matches);
+        } else {
+            positions = std::move(matches);
+            restricted = true;
+        }
+    };
+
+    if (!query.users.isEmpty()) {
+        std::vector<size_t> userPositions;
+
+        for (const QString &user : query.users) {
+            auto it = this->positionsByLoginName.find(user);
+
+            if (it != this->positionsByLoginName.end()) {
+                userPositions.insert(userPositions.end(), it.value().begin(), it.value().end());
+            }
+        }
+
+        std::sort(userPositions.begin(), userPositions.end());
+        restrict(std::move(userPositions));
+    }
+
+    for (const QString &prefix : query.prefixes) {
+        restrict(this->searchIndex.findPrefix(prefix));
+    }
+
+    // messages containing the phrase contain all of its words
+    for (const QString &phrase : query.phrases) {
+        for (const QString &word : SearchIndex::getWords(phrase)) {
+            restrict(this->searchIndex.findWord(word));
+        }
+    }
 
-    if (index >= 0) {
-        this->messageReplaced((size_t)index, replacement);
+    // the phrases don't contain any words
+    if (!restricted) {
+        for (size_t i = 0; i < snapshot.getLength(); i++) {
+            positions.push_back(firstPosition + i);
+        }
     }
+
+    for (size_t position : positions) {
+        const messages::MessagePtr &message = snapshot[position - firstPosition];
+
+        if (!query.phrases.isEmpty()) {
+            QString searchText = message->getSearchText().toCaseFolded();
+
+            bool containsPhrases = std::all_of(
+                query.phrases.begin(), query.phrases.end(),
+                [&searchText](const QString &phrase) { return searchText.contains(phrase); });
+
+            if (!containsPhrases) {
+                continue;
+            }
+        }
+
+        results.push_back(message);
+    }
+
+    return results;
+}
+
+messages::MessagePtr Channel::getMessageAt(size_t position)
+{
+    auto snapshot = this->messages.getSnapshot();
+    size_t firstPosition = this->messages.getFirstPosition();
+
+    if (position < firstPosition || position - firstPosition >= snapshot.getLength()) {
+        return nullptr;
+    }
+
+    return snapshot[position - firstPosition];
+}
+
+void Channel::indexMessage(const messages::MessagePtr &message, size_t position, bool overwrite)
+{
+    if (!this->indexed) {
+        return;
+    }
+
+    if (overwrite) {
+        this->positionsByPointer[message.get()] = position;
+    } else {
+        this->positionsByPointer.emplace(message.get(), position);
+    }
+
+    if (!message->id.isEmpty() && (overwrite || !this->positionsById.contains(message->id))) {
+        this->positionsById.insert(message->id, position);
+    }
+
+    this->searchIndex.addMessage(*message, position);
+
+    if (!message->loginName.isEmpty()) {
+        auto loginIt = this->positionsByLoginName.find(message->loginName);
+
+        if (loginIt == this->positionsByLoginName.end()) {
+            loginIt = this->positionsByLoginName.insert(message->loginName, PositionList());
+            this->indexMemoryUsage += INDEX_ENTRY_SIZE;
+        }
+
+        PositionList &positions = loginIt.value();
+
+        this->indexMemoryUsage -= positions.getMemoryUsage();
+        positions.insert(position);
+        this->indexMemoryUsage += positions.getMemoryUsage();
+    }
+}
+
+void Channel::unindexMessage(const messages::MessagePtr &message, size_t position)
+{
+    if (!this->indexed) {
+        return;
+    }
+
+    // the same message might have been added again at a different position
+    auto it = this->positionsByPointer.find(message.get());
+    if (it != this->positionsByPointer.end() && it->second == position) {
+        this->positionsByPointer.erase(it);
+    }
+
+    if (!message->id.isEmpty()) {
+        auto idIt = this->positionsById.find(message->id);
+        if (idIt != this->positionsById.end() && idIt.value() == position) {
+            this->positionsById.erase(idIt);
+        }
+    }
+
+    this->searchIndex.removeMessage(*message, position);
+
+    if (!message->loginName.isEmpty()) {
+        auto loginIt = this->positionsByLoginName.find(message->loginName);
+        if (loginIt == this->positionsByLoginName.end()) {
+            return;
+        }
+
+        PositionList &positions = loginIt.value();
+
+        this->indexMemoryUsage -= positions.getMemoryUsage();
+        positions.remove(position);
+
+        if (positions.empty()) {
+            this->positionsByLoginName.erase(loginIt);
+            this->indexMemoryUsage -= INDEX_ENTRY_SIZE;
+        } else {
+            this->indexMemoryUsage += positions.getMemoryUsage();
+        }
+    }
+}
+
+void Channel::onMessageRemoved(messages::MessagePtr &deleted, size_t position)
+{
+    this->unindexMessage(deleted, position);
+
+    this->messagesMemoryUsage -= deleted->getEstimatedSize();
+}
+
+void Channel::queueRemovedAtStart(size_t count)
+{
+    // the messages that were delivered are in front of the pending ones
+    size_t pending = this->appendedMessages.size() - this->droppedAppendedMessages;
+    size_t delivered = this->messages.getLength() + count - pending;
+    size_t removedDelivered = std::min(delivered, count);
+
+    this->removedAtStart += removedDelivered;
+    this->droppedAppendedMessages += count - removedDelivered;
+}
+
+void Channel::flushAppendedMessages()
+{
+    this->appendTimer.stop();
+
+    this->appendedMessages.erase(this->appendedMessages.begin(),
+                                 this->appendedMessages.begin() + this->droppedAppendedMessages);
+    this->droppedAppendedMessages = 0;
+
+    if (this->removedAtStart == 0 && this->appendedMessages.empty()) {
+        return;
+    }
+
+    size_t removedAtStart = this->removedAtStart;
+    this->removedAtStart = 0;
+
+    std::vector<MessagePtr> messages;
+    messages.swap(this->appendedMessages);
+
+    this->messagesAppended(removedAtStart, messages);
 }
 
 void Channel::addRecentChatter(const std::shared_ptr<messages::Message> &message)
@@ -86,6 +385,80 @@ void Channel::addRecentChatter(const std::shared_ptr<messages::Message> &message
     this->recentChatters[message->loginName] = {message->displayName, message->localizedName};
 }
 
+void Channel::useScrollbackBudget()
+{
+    if (this->usesScrollbackBudget) {
+        return;
+    }
+
+    this->usesScrollbackBudget = true;
+    singletons::ScrollbackManager::getInstance().addChannel(this);
+}
+
+size_t Channel::getMessageLimit() const
+{
+    return this->messages.getLimit();
+}
+
+void Channel::setMessageLimit(size_t limit)
+{
+    std::vector<messages::MessagePtr> deletedMessages = this->messages.setLimit(limit);
+    size_t position = this->messages.getFirstPosition() - deletedMessages.size();
+
+    if (deletedMessages.empty()) {
+        return;
+    }
+
+    for (messages::MessagePtr &deleted : deletedMessages) {
+        this->onMessageRemoved(deleted, position++);
+    }
+
+    // the views are laid out once, no matter how many messages were cut off
+    this->queueRemovedAtStart(deletedMessages.size());
+    this->flushAppendedMessages();
+}
+
+size_t Channel::getMessageCount() const
+{
+    return this->messages.getLength();
+}
+
+size_t Channel::getMessagesMemoryUsage() const
+{
+    size_t pointerIndexUsage =
+        (this->positionsByPointer.size() + (size_t)this->positionsById.size()) * INDEX_ENTRY_SIZE;
+
+    return this->messagesMemoryUsage + this->indexMemoryUsage + pointerIndexUsage +
+           this->searchIndex.getMemoryUsage();
+}
+
+void Channel::addVisibleView()
+{
+    if (this->visibleViewCount++ == 0) {
+        singletons::ScrollbackManager::getInstance().queueRebalance();
+    }
+}
+
+void Channel::removeVisibleView()
+{
+    assert(this->visibleViewCount > 0);
+
+    if (--this->visibleViewCount == 0) {
+        this->lastVisibleTime = std::chrono::steady_clock::now();
+        singletons::ScrollbackManager::getInstance().queueRebalance();
+    }
+}
+
+int Channel::getVisibleViewCount() const
+{
+    return this->visibleViewCount;
+}
+
+std::chrono::steady_clock::time_point Channel::getLastVisibleTime() const
+{
+    return this->lastVisibleTime;
+}
+
 std::vector<Channel::NameOptions> Channel::getUsernamesForCompletions()
 {
     std::vector<NameOptions> names;
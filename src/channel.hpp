@@ -3,17 +3,24 @@
 #include "messages/image.hpp"
 #include "messages/limitedqueue.hpp"
 #include "messages/message.hpp"
+#include "messages/positionlist.hpp"
+#include "messages/searchindex.hpp"
 #include "util/completionmodel.hpp"
 #include "util/concurrentmap.hpp"
 
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QString>
+#include <QTimer>
 #include <QVector>
 #include <boost/signals2.hpp>
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 namespace chatterino {
 namespace messages {
@@ -23,13 +30,18 @@ struct Message;
 class Channel : public std::enable_shared_from_this<Channel>
 {
 public:
-    explicit Channel(const QString &_name);
+    // a channel that isn't indexed can't find, replace or search its messages, for channels that
+    // only show messages of other channels like search results
+    explicit Channel(const QString &_name, bool _indexed = true);
     virtual ~Channel();
 
     pajlada::Signals::Signal<const QString &, const QString &> sendMessageSignal;
 
-    boost::signals2::signal<void(messages::MessagePtr &)> messageRemovedFromStart;
-    boost::signals2::signal<void(messages::MessagePtr &)> messageAppended;
+    // the changes within a frame are delivered together: first the count of messages that were
+    // removed at the start, then the messages that were appended. the other signals deliver the
+    // pending changes first so the views see them in order
+    boost::signals2::signal<void(size_t removedAtStart, std::vector<messages::MessagePtr> &)>
+        messagesAppended;
     boost::signals2::signal<void(std::vector<messages::MessagePtr> &)> messagesAddedAtStart;
     boost::signals2::signal<void(size_t index, messages::MessagePtr &)> messageReplaced;
     pajlada::Signals::NoArgSignal destroyed;
@@ -38,10 +50,34 @@ public:
     messages::LimitedQueueSnapshot<messages::MessagePtr> getMessageSnapshot();
 
     void addMessage(messages::MessagePtr message);
+    // delivers the changes that are waiting for messagesAppended right away
+    void flushAppendedMessages();
     void addMessagesAtStart(std::vector<messages::MessagePtr> &messages);
     void replaceMessage(messages::MessagePtr message, messages::MessagePtr replacement);
+    // returns nullptr if no message with the id is in the channel
+    messages::MessagePtr findMessage(const QString &messageId);
+    // returns the messages sent by the user that are still in the channel, oldest first
+    std::vector<messages::MessagePtr> getMessagesFromUser(const QString &loginName);
+    // returns the messages matching the query, oldest first, see messages::SearchQuery
+    std::vector<messages::MessagePtr> search(const QString &query);
     void addRecentChatter(const std::shared_ptr<messages::Message> &message);
 
+    // Scrollback
+    // lets the ScrollbackManager manage the limit, only for channels that keep receiving messages
+    void useScrollbackBudget();
+    // lowering the limit removes messages at the start
+    size_t getMessageLimit() const;
+    void setMessageLimit(size_t limit);
+    size_t getMessageCount() const;
+    // the estimated memory used by the messages and the indexes of the channel
+    size_t getMessagesMemoryUsage() const;
+
+    // called by the views showing this channel when they are shown or hidden
+    void addVisibleView();
+    void removeVisibleView();
+    int getVisibleViewCount() const;
+    std::chrono::steady_clock::time_point getLastVisibleTime() const;
+
     struct NameOptions {
         QString displayName;
         QString localizedName;
@@ -71,7 +107,35 @@ protected:
     virtual void onConnected();
 
 private:
+    messages::MessagePtr getMessageAt(size_t position);
+    void indexMessage(const messages::MessagePtr &message, size_t position, bool overwrite);
+    void unindexMessage(const messages::MessagePtr &message, size_t position);
+    void onMessageRemoved(messages::MessagePtr &deleted, size_t position);
+    void queueRemovedAtStart(size_t count);
+
     messages::LimitedQueue<messages::MessagePtr> messages;
+    size_t messagesMemoryUsage = 0;
+
+    const bool indexed;
+
+    // positions of the messages in the queue, only used on the thread adding the messages
+    std::unordered_map<const messages::Message *, size_t> positionsByPointer;
+    QHash<QString, size_t> positionsById;
+    QHash<QString, messages::PositionList> positionsByLoginName;
+    // memory of the login name index, the search index counts its own
+    size_t indexMemoryUsage = 0;
+    messages::SearchIndex searchIndex;
+
+    // changes that weren't delivered yet. appended messages that were removed again before the
+    // delivery are dropped from the start of appendedMessages
+    size_t removedAtStart = 0;
+    std::vector<messages::MessagePtr> appendedMessages;
+    size_t droppedAppendedMessages = 0;
+    QTimer appendTimer;
+
+    bool usesScrollbackBudget = false;
+    int visibleViewCount = 0;
+    std::chrono::steady_clock::time_point lastVisibleTime;
 };
 
 typedef std::shared_ptr<Channel> ChannelPtr;
@@ -0,0 +1,168 @@
+#include "messages/highlightmatcher.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace chatterino {
+namespace messages {
+
+HighlightMatcher::HighlightMatcher(const std::vector<HighlightPhrase> &phrases,
+                                   const QStringList &blacklistedUsers)
+{
+    for (const QString &user : blacklistedUsers) {
+        this->blacklist.insert(user.toCaseFolded());
+    }
+
+    // build a trie of the case folded keys
+    std::vector<std::map<ushort, int>> children(1);
+    std::vector<Node> trie(1);
+
+    for (const HighlightPhrase &phrase : phrases) {
+        int node = 0;
+
+        for (QChar character : phrase.key.toCaseFolded()) {
+            auto it = children[node].find(character.unicode());
+
+            if (it != children[node].end()) {
+                node = it->second;
+            } else {
+                int next = (int)trie.size();
+
+                children[node].emplace(character.unicode(), next);
+                children.emplace_back();
+                trie.emplace_back();
+
+                node = next;
+            }
+        }
+
+        trie[node].flags |= Highlight | (phrase.sound ? Sound : 0) | (phrase.alert ? Alert : 0);
+
+        if (trie[node].key == -1) {
+            trie[node].key = (int)this->keys.size();
+            this->keys.push_back(phrase.key);
+        }
+    }
+
+    // a node fails to the longest suffix of its text that is in the trie. going breadth first
+    // makes sure the suffix is done before the node, so the node can take over its matches.
+    std::vector<int> queue = {0};
+
+    for (size_t i = 0; i < queue.size(); i++) {
+        int node = queue[i];
+
+        for (const auto &child : children[node]) {
+            Node &target = trie[child.second];
+
+            if (node != 0) {
+                int fail = trie[node].fail;
+
+                while (true) {
+                    auto it = children[fail].find(child.first);
+
+                    if (it != children[fail].end()) {
+                        target.fail = it->second;
+                        break;
+                    }
+
+                    if (fail == 0) {
+                        break;
+                    }
+
+                    fail = trie[fail].fail;
+                }
+            }
+
+            const Node &failNode = trie[target.fail];
+
+            target.flags |= failNode.flags;
+
+            if (target.key == -1) {
+                target.key = failNode.key;
+            }
+
+            queue.push_back(child.second);
+        }
+    }
+
+    for (size_t i = 0; i < trie.size(); i++) {
+        trie[i].firstEdge = (int)this->edges.size();
+        trie[i].edgeCount = (int)children[i].size();
+
+        for (const auto &child : children[i]) {
+            this->edges.push_back({child.first, child.second});
+        }
+    }
+
+    this->nodes = std::move(trie);
+}
+
+bool HighlightMatcher::isBlacklisted(const QString &username) const
+{
+    return this->blacklist.contains(username.toCaseFolded());
+}
+
+HighlightMatcher::Result HighlightMatcher::match(const QString &text) const
+{
+    Result result;
+
+    // no phrases
+    if (this->nodes.size() == 1 && this->nodes[0].flags == 0) {
+        return result;
+    }
+
+    int node = 0;
+    int flags = this->nodes[0].flags;
+    int key = this->nodes[0].key;
+
+    for (QChar character : text.toCaseFolded()) {
+        // other phrases can't change the result anymore
+        if (flags == All) {
+            break;
+        }
+
+        node = this->step(node, character.unicode());
+
+        flags |= this->nodes[node].flags;
+
+        if (key == -1) {
+            key = this->nodes[node].key;
+        }
+    }
+
+    result.highlight = (flags & Highlight) != 0;
+    result.sound = (flags & Sound) != 0;
+    result.alert = (flags & Alert) != 0;
+
+    if (key != -1) {
+        result.key = this->keys[key];
+    }
+
+    return result;
+}
+
+int HighlightMatcher::step(int node, ushort character) const
+{
+    while (true) {
+        const Node &current = this->nodes[node];
+
+        auto begin = this->edges.begin() + current.firstEdge;
+        auto end = begin + current.edgeCount;
+        auto it = std::lower_bound(begin, end, character, [](const Edge &edge, ushort c) {
+            return edge.character < c;  //
+        });
+
+        if (it != end && it->character == character) {
+            return it->target;
+        }
+
+        if (node == 0) {
+            return 0;
+        }
+
+        node = current.fail;
+    }
+}
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "messages/highlightphrase.hpp"
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+// Matches all highlight phrases in one pass over a message (Aho-Corasick). It is built once when
+// the highlights change and is only read afterwards, so it can be used from any thread.
+class HighlightMatcher
+{
+public:
+    struct Result {
+        bool highlight = false;
+        bool sound = false;
+        bool alert = false;
+        // one of the phrases that matched
+        QString key;
+    };
+
+    HighlightMatcher() = default;
+    HighlightMatcher(const std::vector<HighlightPhrase> &phrases,
+                     const QStringList &blacklistedUsers);
+
+    bool isBlacklisted(const QString &username) const;
+    // case insensitive, like QString::contains
+    Result match(const QString &text) const;
+
+private:
+    enum Flags {
+        Highlight = 1,
+        Sound = 2,
+        Alert = 4,
+        All = Highlight | Sound | Alert,
+    };
+
+    struct Node {
+        int firstEdge = 0;
+        int edgeCount = 0;
+        int fail = 0;
+        // flags and a key of all phrases that end at this node
+        int flags = 0;
+        int key = -1;
+    };
+
+    struct Edge {
+        ushort character;
+        int target;
+    };
+
+    // the edges of a node are next to each other and sorted by character
+    std::vector<Node> nodes = std::vector<Node>(1);
+    std::vector<Edge> edges;
+    std::vector<QString> keys;
+    QSet<QString> blacklist;
+
+    int step(int node, ushort character) const;
+};
+
+}  // namespace messages
+}  // namespace chatterino
@@ -1,4 +1,5 @@
 #include "messages/image.hpp"
+#include "messages/imagedecoder.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/ircmanager.hpp"
 #include "singletons/windowmanager.hpp"
@@ -7,18 +8,101 @@
 #include "util/urlfetch.hpp"
 
 #include <QBuffer>
+#include <QElapsedTimer>
 #include <QImageReader>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QPainter>
 #include <QTimer>
 
 #include <functional>
+#include <list>
 #include <thread>
+#include <unordered_map>
 
 namespace chatterino {
 namespace messages {
 
+namespace {
+
+// decoded frames of animated images that weren't painted recently are freed once they take up
+// more memory than this
+const size_t MAX_FRAMES_MEMORY_USAGE = 128 * 1024 * 1024;
+
+// frames that were painted within this time are likely on screen and aren't freed
+const qint64 MIN_UNUSED_TIME = 10 * 1000;
+
+size_t getMemoryUsage(const QPixmap &pixmap)
+{
+    return (size_t)pixmap.width() * pixmap.height() * pixmap.depth() / 8;
+}
+
+// Keeps track of the animated images with decoded frames, the ones that weren't painted for the
+// longest time are freed first. Only use it on the gui thread.
+class FrameCache
+{
+public:
+    static FrameCache &getInstance()
+    {
+        static FrameCache instance;
+
+        return instance;
+    }
+
+    // moves the image to the front of the list
+    void touch(Image *image, size_t memoryUsage)
+    {
+        qint64 now = this->clock.elapsed();
+
+        auto it = this->positions.find(image);
+
+        if (it != this->positions.end()) {
+            this->memoryUsage -= it->second->memoryUsage;
+            this->images.erase(it->second);
+        }
+
+        this->images.push_front({image, memoryUsage, now});
+        this->positions[image] = this->images.begin();
+        this->memoryUsage += memoryUsage;
+
+        this->trim(now);
+    }
+
+private:
+    struct Item {
+        Image *image;
+        size_t memoryUsage;
+        qint64 lastUsed;
+    };
+
+    FrameCache()
+    {
+        this->clock.start();
+    }
+
+    std::list<Item> images;
+    std::unordered_map<Image *, std::list<Item>::iterator> positions;
+    size_t memoryUsage = 0;
+    QElapsedTimer clock;
+
+    void trim(qint64 now)
+    {
+        while (this->memoryUsage > MAX_FRAMES_MEMORY_USAGE && !this->images.empty() &&
+               now - this->images.back().lastUsed > MIN_UNUSED_TIME) {
+            Item &item = this->images.back();
+
+            item.image->freeFrames();
+
+            this->memoryUsage -= item.memoryUsage;
+            this->positions.erase(item.image);
+            this->images.pop_back();
+        }
+    }
+};
+
+}  // namespace
+
 Image::Image(const QString &url, qreal scale, const QString &name, const QString &tooltip,
              const QMargins &margin, bool isHat)
     : currentPixmap(nullptr)
@@ -41,8 +125,13 @@ Image::Image(QPixmap *image, qreal scale, const QString &name, const QString &to
     , ishat(isHat)
     , scale(scale)
     , isLoading(true)
-    , isLoaded(true)
 {
+    if (image != nullptr) {
+        this->width = image->width();
+        this->height = image->height();
+    }
+
+    this->isLoaded.store(true, std::memory_order_release);
 }
 
 void Image::loadImage()
@@ -51,68 +140,134 @@ void Image::loadImage()
     req.setCaller(this);
     req.setUseQuickLoadCache(true);
     req.get([lli = this](QByteArray bytes) {
-        QByteArray copy = QByteArray::fromRawData(bytes.constData(), bytes.length());
-        QBuffer buffer(&copy);
-        buffer.open(QIODevice::ReadOnly);
-
-        QImage image;
-        QImageReader reader(&buffer);
+        // the pixmaps are created on the gui thread, the views are laid out once for all images
+        // that finished in the same frame
+        ImageDecoder::getInstance().decode(bytes,
+                                           [lli, bytes](DecodedFrames &decoded) {
+                                               if (decoded.durations.size() > 1) {
+                                                   lli->data = bytes;
+                                               }
+
+                                               lli->setFrames(decoded);
+                                               lli->isLoaded.store(true,
+                                                                   std::memory_order_release);
+                                           },
+                                           true);
+    });
+}
 
-        bool first = true;
+void Image::setFrames(DecodedFrames &decoded)
+{
+    if (decoded.image.isNull()) {
+        return;
+    }
 
-        for (int index = 0; index < reader.imageCount(); ++index) {
-            if (reader.read(&image)) {
-                auto pixmap = new QPixmap(QPixmap::fromImage(image));
+    if (decoded.durations.size() <= 1) {
+        if (!this->animated) {
+            this->currentPixmap = new QPixmap(QPixmap::fromImage(decoded.image));
+            this->width = this->currentPixmap->width();
+            this->height = this->currentPixmap->height();
+        }
+        return;
+    }
 
-                if (first) {
-                    first = false;
-                    lli->loadedPixmap = pixmap;
-                }
+    this->frames.reset(new QPixmap(QPixmap::fromImage(decoded.image)));
+    this->frameSize = decoded.frameSize;
+    this->columns = decoded.columns;
 
-                chatterino::messages::Image::FrameData data;
-                data.duration = std::max(20, reader.nextImageDelay());
-                data.image = pixmap;
+    if (!this->animated) {
+        this->frameDurations = std::move(decoded.durations);
+        this->totalDuration = 0;
 
-                lli->allFrames.push_back(data);
-            }
+        for (int duration : this->frameDurations) {
+            this->totalDuration += duration;
         }
 
-        if (lli->allFrames.size() > 1) {
-            lli->animated = true;
-        }
+        this->animated = true;
+        this->width = this->frameSize.width();
+        this->height = this->frameSize.height();
+    }
 
-        lli->currentPixmap = lli->loadedPixmap;
+    FrameCache::getInstance().touch(this, getMemoryUsage(*this->frames));
+}
 
-        lli->isLoaded = true;
+void Image::decodeFrames()
+{
+    if (this->isDecoding) {
+        return;
+    }
 
-        singletons::EmoteManager::getInstance().incGeneration();
+    this->isDecoding = true;
 
-        util::postToThread(
-            [] { singletons::WindowManager::getInstance().layoutVisibleChatWidgets(); });
-    });
+    // the size didn't change, the frames are painted with the next frame of the animation
+    ImageDecoder::getInstance().decode(this->data,
+                                       [this](DecodedFrames &decoded) {
+                                           this->isDecoding = false;
+                                           this->setFrames(decoded);
+                                       },
+                                       false);
+}
 
-    singletons::EmoteManager::getInstance().getGifUpdateSignal().connect([=]() {
-        this->gifUpdateTimout();
-    });  // For some reason when Boost signal is in thread scope and thread deletes the signal
-         // doesn't work, so this is the fix.
+void Image::freeFrames()
+{
+    this->frames.reset();
 }
 
-void Image::gifUpdateTimout()
+bool Image::updateFrame(qint64 time)
 {
-    if (this->animated) {
-        this->currentFrameOffset += GIF_FRAME_LENGTH;
+    if (!this->isLoaded || !this->animated || time < this->nextFrameTime) {
+        return false;
+    }
+
+    // all images are in sync, the frame only depends on the time
+    qint64 offset = time % this->totalDuration;
+    qint64 frameEnd = 0;
+    int frame = 0;
+
+    for (; frame < (int)this->frameDurations.size() - 1; frame++) {
+        frameEnd += this->frameDurations[frame];
 
-        while (true) {
-            if (this->currentFrameOffset > this->allFrames.at(this->currentFrame).duration) {
-                this->currentFrameOffset -= this->allFrames.at(this->currentFrame).duration;
-                this->currentFrame = (this->currentFrame + 1) % this->allFrames.size();
-            } else {
-                break;
-            }
+        if (offset < frameEnd) {
+            break;
         }
+    }
+
+    if (frame == (int)this->frameDurations.size() - 1) {
+        frameEnd = this->totalDuration;
+    }
+
+    this->nextFrameTime = time - offset + frameEnd;
 
-        this->currentPixmap = this->allFrames[this->currentFrame].image;
+    bool changed = frame != this->currentFrame;
+
+    this->currentFrame = frame;
+
+    return changed;
+}
+
+qint64 Image::getNextFrameTime() const
+{
+    return this->nextFrameTime;
+}
+
+void Image::paintFrame(QPainter &painter, const QRectF &rect)
+{
+    if (!this->isLoaded || !this->animated) {
+        return;
     }
+
+    if (!this->frames) {
+        this->decodeFrames();
+        return;
+    }
+
+    FrameCache::getInstance().touch(this, getMemoryUsage(*this->frames));
+
+    QRect source(QPoint((this->currentFrame % this->columns) * this->frameSize.width(),
+                        (this->currentFrame / this->columns) * this->frameSize.height()),
+                 this->frameSize);
+
+    painter.drawPixmap(rect, *this->frames, source);
 }
 
 const QPixmap *Image::getPixmap()
@@ -167,13 +322,18 @@ bool Image::isHat() const
     return this->ishat;
 }
 
+bool Image::hasLoaded() const
+{
+    return this->isLoaded.load(std::memory_order_acquire);
+}
+
 int Image::getWidth() const
 {
-    if (this->currentPixmap == nullptr) {
+    if (!this->isLoaded.load(std::memory_order_acquire)) {
         return 16;
     }
 
-    return this->currentPixmap->width();
+    return this->width;
 }
 
 int Image::getScaledWidth() const
@@ -183,10 +343,11 @@ int Image::getScaledWidth() const
 
 int Image::getHeight() const
 {
-    if (this->currentPixmap == nullptr) {
+    if (!this->isLoaded.load(std::memory_order_acquire)) {
         return 16;
     }
-    return this->currentPixmap->height();
+
+    return this->height;
 }
 
 int Image::getScaledHeight() const
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <QByteArray>
 #include <QPixmap>
 #include <QString>
 #include <boost/noncopyable.hpp>
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
+
+class QPainter;
 
 namespace chatterino {
 namespace messages {
+struct DecodedFrames;
 
 class Image : public QObject, boost::noncopyable
 {
@@ -23,6 +29,7 @@ public:
                    const QString &_tooltip = "", const QMargins &_margin = QMargins(),
                    bool isHat = false);
 
+    // the pixmap of a static image, animated images are drawn with paintFrame
     const QPixmap *getPixmap();
     qreal getScale() const;
     const QString &getUrl() const;
@@ -31,22 +38,38 @@ public:
     const QMargins &getMargin() const;
     bool isAnimated() const;
     bool isHat() const;
+    // the size of the image is only known after it finished loading
+    bool hasLoaded() const;
     int getWidth() const;
     int getScaledWidth() const;
     int getHeight() const;
     int getScaledHeight() const;
 
-private:
-    struct FrameData {
-        QPixmap *image;
-        int duration;
-    };
+    // animation, see layouts::AnimationScheduler
+    // shows the frame for the time in ms, returns true if a different frame is shown now
+    bool updateFrame(qint64 time);
+    // time in ms at which the next frame is shown
+    qint64 getNextFrameTime() const;
+    // draws the current frame, the frames are decoded again first if they were freed
+    void paintFrame(QPainter &painter, const QRectF &rect);
+    // frees the decoded frames of an animated image, only the downloaded data is kept
+    void freeFrames();
 
+private:
     QPixmap *currentPixmap;
-    QPixmap *loadedPixmap;
-    std::vector<FrameData> allFrames;
+
+    // animated images
+    // the frames are kept in a single pixmap and decoded from the data again after they were
+    // freed
+    QByteArray data;
+    std::unique_ptr<QPixmap> frames;
+    QSize frameSize;
+    int columns = 1;
+    std::vector<int> frameDurations;
+    bool isDecoding = false;
     int currentFrame = 0;
-    int currentFrameOffset = 0;
+    int totalDuration = 0;
+    qint64 nextFrameTime = 0;
 
     QString url;
     QString name;
@@ -56,11 +79,17 @@ private:
     bool ishat;
     qreal scale;
 
+    // the size is read by the layouts on the worker threads. it's set before isLoaded is, which
+    // publishes it, and doesn't change afterwards.
+    int width = 16;
+    int height = 16;
+
     bool isLoading = false;
     std::atomic<bool> isLoaded{false};
 
     void loadImage();
-    void gifUpdateTimout();
+    void setFrames(DecodedFrames &decoded);
+    void decodeFrames();
 };
 
 }  // namespace messages
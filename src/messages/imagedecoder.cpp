@@ -0,0 +1,143 @@
+#include "messages/imagedecoder.hpp"
+#include "singletons/windowmanager.hpp"
+#include "util/posttothread.hpp"
+
+#include <QBuffer>
+#include <QImageReader>
+#include <QPainter>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+// the results that finished within this time are applied together
+const int BATCH_INTERVAL = 16;
+
+}  // namespace
+
+ImageDecoder::ImageDecoder()
+{
+    // the other half is left to the gui thread and the layout threads
+    this->pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+ImageDecoder &ImageDecoder::getInstance()
+{
+    static ImageDecoder instance;
+
+    return instance;
+}
+
+void ImageDecoder::decode(const QByteArray &data, std::function<void(DecodedFrames &)> finished,
+                          bool layoutRequired)
+{
+    auto result = std::make_shared<Result>();
+    result->finished = std::move(finished);
+    result->layoutRequired = layoutRequired;
+
+    this->pool.start(new util::LambdaRunnable([this, data, result] {
+        result->frames = ImageDecoder::decodeFrames(data);
+
+        this->addResult(result);
+    }));
+}
+
+void ImageDecoder::addResult(std::shared_ptr<Result> result)
+{
+    std::lock_guard<std::mutex> lock(this->resultsMutex);
+
+    this->results.push_back(std::move(result));
+
+    // the first result of a batch starts the timer, the following ones are added to it
+    if (!this->batchQueued) {
+        this->batchQueued = true;
+
+        util::postToThread([this] {
+            QTimer::singleShot(BATCH_INTERVAL, [this] { this->finishBatch(); });
+        });
+    }
+}
+
+void ImageDecoder::finishBatch()
+{
+    std::vector<std::shared_ptr<Result>> batch;
+
+    {
+        std::lock_guard<std::mutex> lock(this->resultsMutex);
+
+        batch.swap(this->results);
+        this->batchQueued = false;
+    }
+
+    bool layoutRequired = false;
+
+    for (const std::shared_ptr<Result> &result : batch) {
+        result->finished(result->frames);
+
+        layoutRequired |= result->layoutRequired;
+    }
+
+    // only the layouts that use one of the images are computed again, see
+    // MessageLayoutContainer::addImageDependency
+    if (layoutRequired) {
+        singletons::WindowManager::getInstance().layoutVisibleChatWidgets();
+    }
+}
+
+DecodedFrames ImageDecoder::decodeFrames(const QByteArray &data)
+{
+    DecodedFrames decoded;
+
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer);
+    QImage image;
+
+    if (!reader.read(&image)) {
+        return decoded;
+    }
+
+    int count = reader.imageCount();
+    decoded.frameSize = image.size();
+
+    if (count <= 1) {
+        decoded.image = image;
+        return decoded;
+    }
+
+    // a single column would exceed the maximum pixmap size for long gifs
+    decoded.columns = (int)std::ceil(std::sqrt(count));
+    int rows = (count + decoded.columns - 1) / decoded.columns;
+
+    decoded.image = QImage(decoded.frameSize.width() * decoded.columns,
+                           decoded.frameSize.height() * rows, QImage::Format_ARGB32_Premultiplied);
+    decoded.image.fill(Qt::transparent);
+
+    QPainter painter(&decoded.image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+    for (int index = 0; index < count; index++) {
+        if (index != 0 && !reader.read(&image)) {
+            break;
+        }
+
+        painter.drawImage(QPoint((index % decoded.columns) * decoded.frameSize.width(),
+                                 (index / decoded.columns) * decoded.frameSize.height()),
+                          image);
+
+        decoded.durations.push_back(std::max(20, reader.nextImageDelay()));
+    }
+
+    return decoded;
+}
+
+}  // namespace messages
+}  // namespace chatterino
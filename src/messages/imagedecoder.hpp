@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QThreadPool>
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+// all frames of an animated image in a grid, a single image is not split into frames
+struct DecodedFrames {
+    QImage image;
+    QSize frameSize;
+    int columns = 1;
+    std::vector<int> durations;
+};
+
+// Decodes downloaded images on its own threads. The results are handed to the gui thread in
+// batches, at most once per frame, so loading many emotes at once only lays out the views once.
+class ImageDecoder : boost::noncopyable
+{
+    ImageDecoder();
+
+public:
+    static ImageDecoder &getInstance();
+
+    // decodes the image on a decoder thread, finished is called on the gui thread with the next
+    // batch. the visible views are laid out after the batch if one of them requires it.
+    void decode(const QByteArray &data, std::function<void(DecodedFrames &)> finished,
+                bool layoutRequired);
+
+    static DecodedFrames decodeFrames(const QByteArray &data);
+
+private:
+    struct Result {
+        DecodedFrames frames;
+        std::function<void(DecodedFrames &)> finished;
+        bool layoutRequired;
+    };
+
+    QThreadPool pool;
+
+    std::mutex resultsMutex;
+    std::vector<std::shared_ptr<Result>> results;
+    bool batchQueued = false;
+
+    void addResult(std::shared_ptr<Result> result);
+    void finishBatch();
+};
+
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,120 @@
+#include "messages/layouts/animationscheduler.hpp"
+#include "messages/image.hpp"
+#include "singletons/settingsmanager.hpp"
+
+#include <QRegion>
+#include <QWidget>
+
+#include <algorithm>
+#include <limits>
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+AnimationScheduler::AnimationScheduler()
+{
+    this->clock.start();
+
+    // a coarse timer can wake up before the frame is due
+    this->timer.setTimerType(Qt::PreciseTimer);
+    this->timer.setSingleShot(true);
+
+    QObject::connect(&this->timer, &QTimer::timeout, [this] {
+        this->advanceFrames();  //
+    });
+
+    singletons::SettingManager::getInstance().enableGifAnimations.connect(
+        [this](auto, auto) { this->schedule(); });
+}
+
+AnimationScheduler &AnimationScheduler::getInstance()
+{
+    static AnimationScheduler instance;
+
+    return instance;
+}
+
+void AnimationScheduler::setVisibleAnimations(QWidget *widget,
+                                              std::vector<VisibleAnimation> animations)
+{
+    if (animations.empty()) {
+        this->widgets.erase(widget);
+    } else {
+        this->widgets[widget] = std::move(animations);
+    }
+
+    this->schedule();
+}
+
+void AnimationScheduler::removeWidget(QWidget *widget)
+{
+    this->widgets.erase(widget);
+
+    this->schedule();
+}
+
+qint64 AnimationScheduler::now() const
+{
+    return this->clock.elapsed();
+}
+
+void AnimationScheduler::schedule()
+{
+    if (!singletons::SettingManager::getInstance().enableGifAnimations.getValue()) {
+        this->timer.stop();
+        return;
+    }
+
+    qint64 nextFrameTime = std::numeric_limits<qint64>::max();
+
+    for (const auto &widget : this->widgets) {
+        for (const VisibleAnimation &animation : widget.second) {
+            if (animation.image->isAnimated()) {
+                nextFrameTime = std::min(nextFrameTime, animation.image->getNextFrameTime());
+            }
+        }
+    }
+
+    // nothing animated on screen, sleep until a view shows an animated image again
+    if (nextFrameTime == std::numeric_limits<qint64>::max()) {
+        this->timer.stop();
+        return;
+    }
+
+    this->timer.start((int)std::max<qint64>(0, nextFrameTime - this->now()));
+}
+
+void AnimationScheduler::advanceFrames()
+{
+    qint64 now = this->now();
+
+    // an image can be visible several times, its frame is only advanced once
+    std::unordered_map<Image *, bool> frameChanged;
+
+    for (const auto &widget : this->widgets) {
+        QRegion region;
+
+        for (const VisibleAnimation &animation : widget.second) {
+            auto it = frameChanged.find(animation.image);
+
+            if (it == frameChanged.end()) {
+                it = frameChanged.emplace(animation.image, animation.image->updateFrame(now)).first;
+            }
+
+            if (it->second) {
+                region += animation.rect;
+            }
+        }
+
+        if (!region.isEmpty()) {
+            widget.first->update(region);
+        }
+    }
+
+    this->schedule();
+}
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
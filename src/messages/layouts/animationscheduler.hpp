@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QRect>
+#include <QTimer>
+#include <boost/noncopyable.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+class QWidget;
+
+namespace chatterino {
+namespace messages {
+class Image;
+
+namespace layouts {
+
+// an animated image and where it is drawn in a widget
+struct VisibleAnimation {
+    Image *image;
+    QRect rect;
+};
+
+// Advances the frames of the animated images that are visible. The timer only wakes up for the
+// next frame of a visible image and only the rects of the images that changed are repainted, it
+// doesn't run at all while no animated image is visible. Only use it on the gui thread.
+class AnimationScheduler : boost::noncopyable
+{
+    AnimationScheduler();
+
+public:
+    static AnimationScheduler &getInstance();
+
+    // replaces the animated images that are visible in the widget
+    void setVisibleAnimations(QWidget *widget, std::vector<VisibleAnimation> animations);
+    void removeWidget(QWidget *widget);
+
+    // milliseconds since the scheduler was created, the frames of all images are based on it
+    qint64 now() const;
+
+private:
+    QTimer timer;
+    QElapsedTimer clock;
+    std::unordered_map<QWidget *, std::vector<VisibleAnimation>> widgets;
+
+    void schedule();
+    void advanceFrames();
+};
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
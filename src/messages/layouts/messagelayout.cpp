@@ -1,4 +1,5 @@
 #include "messages/layouts/messagelayout.hpp"
+#include "messages/layouts/pixmappool.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/settingsmanager.hpp"
 
@@ -8,10 +9,6 @@
 #include <QThread>
 #include <QtGlobal>
 
-#define MARGIN_LEFT (int)(8 * this->scale)
-#define MARGIN_RIGHT (int)(8 * this->scale)
-#define MARGIN_TOP (int)(4 * this->scale)
-#define MARGIN_BOTTOM (int)(4 * this->scale)
 #define COMPACT_EMOTES_OFFSET 6
 
 namespace chatterino {
@@ -20,13 +17,18 @@ namespace layouts {
 
 MessageLayout::MessageLayout(MessagePtr _message)
     : message(_message)
-    , buffer(nullptr)
+    , container(new MessageLayoutContainer)
 {
     if (_message->flags & Message::Collapsed) {
         this->flags &= MessageLayout::Collapsed;
     }
 }
 
+MessageLayout::~MessageLayout()
+{
+    this->deleteBuffer();
+}
+
 Message *MessageLayout::getMessage()
 {
     return this->message.get();
@@ -35,129 +37,250 @@ Message *MessageLayout::getMessage()
 // Height
 int MessageLayout::getHeight() const
 {
-    return container.getHeight();
+    return this->container->getHeight();
 }
 
 // Layout
-// return true if redraw is required
+MessageLayoutKey MessageLayoutKey::current(int width, float scale, MessageElement::Flags flags)
+{
+    MessageLayoutKey key;
+
+    key.width = width;
+    key.scale = scale;
+    key.flags = flags;
+    key.fontGeneration = singletons::FontManager::getInstance().getGeneration();
+    key.emoteGeneration = singletons::EmoteManager::getInstance().getGeneration();
+    key.colors = singletons::ThemeManager::getInstance().getMessageColors();
+
+    auto &settings = singletons::SettingManager::getInstance();
+
+    key.timestampFormat = settings.timestampFormat.getValue();
+    key.emoteQuality = settings.preferredEmoteQuality.getValue();
+    key.moderationActions = settings.getModerationActions();
+
+    return key;
+}
+
+bool MessageLayoutKey::isOutdated() const
+{
+    auto &settings = singletons::SettingManager::getInstance();
+
+    return this->fontGeneration != singletons::FontManager::getInstance().getGeneration() ||
+           this->emoteGeneration != singletons::EmoteManager::getInstance().getGeneration() ||
+           this->colors != singletons::ThemeManager::getInstance().getMessageColors() ||
+           this->timestampFormat != settings.timestampFormat.getValue() ||
+           this->emoteQuality != settings.preferredEmoteQuality.getValue() ||
+           this->moderationActions != settings.getModerationActions();
+}
+
+bool MessageLayoutKey::operator==(const MessageLayoutKey &other) const
+{
+    return this->width == other.width && this->scale == other.scale &&
+           this->flags == other.flags && this->fontGeneration == other.fontGeneration &&
+           this->emoteGeneration == other.emoteGeneration && this->colors == other.colors &&
+           this->timestampFormat == other.timestampFormat &&
+           this->emoteQuality == other.emoteQuality &&
+           this->moderationActions == other.moderationActions;
+}
+
+bool MessageLayoutKey::operator!=(const MessageLayoutKey &other) const
+{
+    return !(*this == other);
+}
+
 bool MessageLayout::layout(int width, float scale, MessageElement::Flags flags)
 {
-    auto &emoteManager = singletons::EmoteManager::getInstance();
+    return this->layout(MessageLayoutKey::current(width, scale, flags));
+}
+
+bool MessageLayout::layout(const MessageLayoutKey &key)
+{
+    if (!this->isLayoutRequired(key)) {
+        return false;
+    }
 
-    bool layoutRequired = false;
+    // a pending layout would overwrite this one when it's done
+    this->pendingKey = boost::none;
 
-    // check if width changed
-    bool widthChanged = width != this->currentLayoutWidth;
-    layoutRequired |= widthChanged;
-    this->currentLayoutWidth = width;
+    if (this->canRewrap(key)) {
+        this->container->rewrap(key.width);
+        this->currentKey = key;
 
-    // check if emotes changed
-    bool imagesChanged = this->emoteGeneration != emoteManager.getGeneration();
-    layoutRequired |= imagesChanged;
-    this->emoteGeneration = emoteManager.getGeneration();
+        this->deleteBuffer();
+        this->invalidateBuffer();
 
-    // check if text changed
-    bool textChanged =
-        this->fontGeneration != singletons::FontManager::getInstance().getGeneration();
-    layoutRequired |= textChanged;
-    this->fontGeneration = singletons::FontManager::getInstance().getGeneration();
+        return true;
+    }
 
-    // check if work mask changed
-    bool wordMaskChanged = this->currentWordFlags !=
-                           flags;  // singletons::SettingManager::getInstance().getWordTypeMask();
-    layoutRequired |= wordMaskChanged;
-    this->currentWordFlags = flags;  // singletons::SettingManager::getInstance().getWordTypeMask();
+    this->commitLayout(this->computeLayout(key, this->message->flags.value), key);
 
-    // check if timestamp format changed
-    bool timestampFormatChanged =
-        this->timestampFormat != singletons::SettingManager::getInstance().timestampFormat;
+    return true;
+}
 
-    layoutRequired |= timestampFormatChanged;
+bool MessageLayout::hasLayout() const
+{
+    return bool(this->currentKey);
+}
 
-    // check if dpi changed
-    bool scaleChanged = this->scale != scale;
-    layoutRequired |= scaleChanged;
-    this->scale = scale;
-    imagesChanged |= scaleChanged;
-    textChanged |= scaleChanged;
+bool MessageLayout::isLayoutRequired(const MessageLayoutKey &key) const
+{
+    return !this->currentKey || *this->currentKey != key || this->container->hasImageChanged();
+}
 
-    // update word sizes if needed
-    if (imagesChanged) {
-        //        this->container.updateImages();
-        this->flags &= MessageLayout::RequiresBufferUpdate;
+bool MessageLayout::canRewrap(const MessageLayoutKey &key) const
+{
+    if (!this->currentKey || this->container->hasImageChanged()) {
+        return false;
+    }
+
+    MessageLayoutKey rewrapKey = *this->currentKey;
+    rewrapKey.width = key.width;
+
+    return rewrapKey == key && this->container->canRewrap(key.width);
+}
+
+int MessageLayout::getEstimatedHeight(const MessageLayoutKey &key)
+{
+    if (!this->isLayoutRequired(key)) {
+        return this->getHeight();
     }
-    if (textChanged) {
-        //        this->container.updateText();
-        this->flags &= MessageLayout::RequiresBufferUpdate;
+
+    if (this->estimateKey && *this->estimateKey == key && !this->estimate->hasImageChanged()) {
+        return this->estimate->getHeight();
     }
-    if (widthChanged || wordMaskChanged) {
-        this->deleteBuffer();
+
+    std::unique_ptr<MessageLayoutContainer> container(new MessageLayoutContainer);
+
+    {
+        std::lock_guard<std::mutex> lock(this->message->layoutMutex);
+
+        container->beginHeightEstimate(key.width, key.scale, this->message->flags.value, key);
+
+        for (MessageElement *element : this->message->getElements()) {
+            element->addToContainer(*container, key.flags);
+        }
+
+        container->finish();
     }
 
-    // return if no layout is required
-    if (!layoutRequired) {
+    this->estimate = std::move(container);
+    this->estimateKey = key;
+
+    return this->estimate->getHeight();
+}
+
+std::unique_ptr<MessageLayoutContainer> MessageLayout::computeLayout(
+    const MessageLayoutKey &key, Message::MessageFlags flags) const
+{
+    std::unique_ptr<MessageLayoutContainer> container(new MessageLayoutContainer);
+
+    std::lock_guard<std::mutex> lock(this->message->layoutMutex);
+
+    container->begin(key.width, key.scale, flags, key);
+
+    for (MessageElement *element : this->message->getElements()) {
+        element->addToContainer(*container, key.flags);
+    }
+
+    container->finish();
+
+    return container;
+}
+
+bool MessageLayout::setLayoutPending(const MessageLayoutKey &key)
+{
+    if (this->pendingKey && *this->pendingKey == key) {
         return false;
     }
 
-    this->actuallyLayout(width, flags);
-    this->invalidateBuffer();
+    this->pendingKey = key;
 
     return true;
 }
 
-void MessageLayout::actuallyLayout(int width, MessageElement::Flags flags)
+bool MessageLayout::commitPendingLayout(std::unique_ptr<MessageLayoutContainer> container,
+                                        const MessageLayoutKey &key)
 {
-    this->container.begin(width, this->scale, this->message->flags.value);
+    if (!this->pendingKey || *this->pendingKey != key) {
+        return false;
+    }
 
-    for (const std::unique_ptr<MessageElement> &element : this->message->getElements()) {
-        element->addToContainer(this->container, flags);
+    this->pendingKey = boost::none;
+
+    this->commitLayout(std::move(container), key);
+
+    return true;
+}
+
+void MessageLayout::cancelPendingLayout(const MessageLayoutKey &key)
+{
+    if (this->pendingKey && *this->pendingKey == key) {
+        this->pendingKey = boost::none;
     }
+}
+
+void MessageLayout::commitLayout(std::unique_ptr<MessageLayoutContainer> container,
+                                 const MessageLayoutKey &key)
+{
+    bool sizeChanged = !this->currentKey || this->currentKey->width != key.width ||
+                       this->currentKey->flags != key.flags ||
+                       this->container->getHeight() != container->getHeight();
 
-    if (this->height != this->container.getHeight()) {
+    if (sizeChanged) {
         this->deleteBuffer();
     }
 
-    this->container.finish();
-    this->height = this->container.getHeight();
+    this->container = std::move(container);
+    this->currentKey = key;
+
+    this->estimate = nullptr;
+    this->estimateKey = boost::none;
+
+    this->invalidateBuffer();
 }
 
 // Painting
 void MessageLayout::paint(QPainter &painter, int y, int messageIndex, Selection &selection,
                           bool isLastReadMessage, bool isWindowFocused)
 {
-    QPixmap *pixmap = this->buffer.get();
     singletons::ThemeManager &themeManager = singletons::ThemeManager::getInstance();
 
-    // create new buffer if required
-    if (!pixmap) {
 #ifdef Q_OS_MACOS
-        pixmap =
-            new QPixmap((int)(this->container.getWidth() * painter.device()->devicePixelRatioF()),
-                        (int)(this->container.getHeight() * painter.device()->devicePixelRatioF()));
-        pixmap->setDevicePixelRatio(painter.device()->devicePixelRatioF());
+    qreal devicePixelRatio = painter.device()->devicePixelRatioF();
+    QSize bufferSize((int)(this->container->getWidth() * devicePixelRatio),
+                     (int)(this->container->getHeight() * devicePixelRatio));
 #else
-        pixmap = new QPixmap(this->container.getWidth(), std::max(16, this->container.getHeight()));
+    qreal devicePixelRatio = 1;
+    QSize bufferSize(this->container->getWidth(), std::max(16, this->container->getHeight()));
 #endif
 
-        this->buffer = std::shared_ptr<QPixmap>(pixmap);
+    // take a buffer from the pool if there is none or it has the wrong size, the buffers are
+    // bigger than the message
+    if (!this->buffer || this->buffer->size() != PixmapPool::getBucketSize(bufferSize) ||
+        this->buffer->devicePixelRatio() != devicePixelRatio) {
+        this->deleteBuffer();
+
+        this->buffer = PixmapPool::getInstance().take(bufferSize, devicePixelRatio);
         this->bufferValid = false;
     }
 
+    QPixmap *pixmap = this->buffer.get();
+
     if (!this->bufferValid || !selection.isEmpty()) {
         this->updateBuffer(pixmap, messageIndex, selection);
     }
 
     // draw on buffer
-    painter.drawPixmap(0, y, *pixmap);
-    //    painter.drawPixmap(0, y, this->container.width, this->container.getHeight(), *pixmap);
+    painter.drawPixmap(QPoint(0, y), *pixmap, QRect(QPoint(0, 0), bufferSize));
 
     // draw disabled
     if (this->message->flags & Message::Disabled) {
-        painter.fillRect(0, y, pixmap->width(), pixmap->height(), themeManager.messages.disabled);
+        painter.fillRect(0, y, this->container->getWidth(), this->container->getHeight(),
+                         themeManager.messages.disabled);
     }
 
     // draw gif emotes
-    this->container.paintAnimatedElements(painter, y);
+    this->container->paintAnimatedElements(painter, y);
 
     // draw last read message line
     if (isLastReadMessage) {
@@ -166,13 +289,18 @@ void MessageLayout::paint(QPainter &painter, int y, int messageIndex, Selection
 
         QBrush brush = QBrush(color, Qt::VerPattern);
 
-        painter.fillRect(0, y + this->container.getHeight() - 1, this->container.getWidth(), 1,
+        painter.fillRect(0, y + this->container->getHeight() - 1, this->container->getWidth(), 1,
                          brush);
     }
 
     this->bufferValid = true;
 }
 
+void MessageLayout::addAnimations(std::vector<VisibleAnimation> &animations, int y) const
+{
+    this->container->addAnimations(animations, y);
+}
+
 void MessageLayout::updateBuffer(QPixmap *buffer, int messageIndex, Selection &selection)
 {
     singletons::ThemeManager &themeManager = singletons::ThemeManager::getInstance();
@@ -188,11 +316,11 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int messageIndex, Selection &s
 
     // draw selection
     if (!selection.isEmpty()) {
-        this->container.paintSelection(painter, messageIndex, selection);
+        this->container->paintSelection(painter, messageIndex, selection);
     }
 
     // draw message
-    this->container.paintElements(painter);
+    this->container->paintElements(painter);
 
 #ifdef OHHEYITSFOURTF
     // debug
@@ -203,7 +331,7 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int messageIndex, Selection &s
     QTextOption option;
     option.setAlignment(Qt::AlignRight | Qt::AlignTop);
 
-    painter.drawText(QRectF(1, 1, this->container.width - 3, 1000),
+    painter.drawText(QRectF(1, 1, this->container->width - 3, 1000),
                      QString::number(++this->bufferUpdatedCount), option);
 #endif
 }
@@ -215,7 +343,9 @@ void MessageLayout::invalidateBuffer()
 
 void MessageLayout::deleteBuffer()
 {
-    this->buffer = nullptr;
+    if (this->buffer) {
+        PixmapPool::getInstance().giveBack(std::move(this->buffer));
+    }
 }
 
 // Elements
@@ -227,22 +357,22 @@ void MessageLayout::deleteBuffer()
 const MessageLayoutElement *MessageLayout::getElementAt(QPoint point)
 {
     // go through all words and return the first one that contains the point.
-    return this->container.getElementAt(point);
+    return this->container->getElementAt(point);
 }
 
 int MessageLayout::getLastCharacterIndex() const
 {
-    return this->container.getLastCharacterIndex();
+    return this->container->getLastCharacterIndex();
 }
 
 int MessageLayout::getSelectionIndex(QPoint position)
 {
-    return this->container.getSelectionIndex(position);
+    return this->container->getSelectionIndex(position);
 }
 
 void MessageLayout::addSelectionText(QString &str, int from, int to)
 {
-    this->container.addSelectionText(str, from, to);
+    this->container->addSelectionText(str, from, to);
 }
 }  // namespace layouts
 }  // namespace messages
@@ -4,23 +4,53 @@
 #include "messages/layouts/messagelayoutelement.hpp"
 #include "messages/message.hpp"
 #include "messages/selection.hpp"
+#include "singletons/helper/moderationaction.hpp"
+#include "singletons/thememanager.hpp"
 #include "util/flagsenum.hpp"
 
 #include <QPixmap>
 
 #include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
 #include <cinttypes>
 #include <memory>
+#include <vector>
 
 namespace chatterino {
 namespace messages {
 namespace layouts {
+
+// Everything a layout depends on, a message has to be laid out again when one of them changed.
+// The settings are copied on the gui thread, so the layouts on the worker threads don't read them
+// while they are changed.
+struct MessageLayoutKey {
+    int width = -1;
+    float scale = -1;
+    MessageElement::Flags flags = MessageElement::None;
+    int fontGeneration = -1;
+    int emoteGeneration = -1;
+    QString timestampFormat;
+    int emoteQuality = 0;
+    std::shared_ptr<const std::vector<singletons::ModerationAction>> moderationActions;
+    std::shared_ptr<const singletons::ThemeManager::MessageColors> colors;
+
+    // creates a key with the current fonts, emotes, theme and settings, call it on the gui thread
+    static MessageLayoutKey current(int width, float scale, MessageElement::Flags flags);
+
+    // whether the fonts, emotes, theme or settings changed since the key was created
+    bool isOutdated() const;
+
+    bool operator==(const MessageLayoutKey &other) const;
+    bool operator!=(const MessageLayoutKey &other) const;
+};
+
 class MessageLayout : boost::noncopyable
 {
 public:
     enum Flags : uint8_t { Collapsed, RequiresBufferUpdate, RequiresLayout };
 
     MessageLayout(MessagePtr message);
+    ~MessageLayout();
 
     Message *getMessage();
 
@@ -31,13 +61,37 @@ public:
     util::FlagsEnum<Flags> flags;
 
     // Layout
+    // lays out the message right away, returns true if a redraw is required
     bool layout(int width, float scale, MessageElement::Flags flags);
+    bool layout(const MessageLayoutKey &key);
+    bool hasLayout() const;
+    bool isLayoutRequired(const MessageLayoutKey &key) const;
+    // whether only the width changed, the lines can then be wrapped again without measuring
+    bool canRewrap(const MessageLayoutKey &key) const;
+
+    // height the message has when it's laid out with the key, computed without creating layout
+    // elements unless the current layout is up to date
+    int getEstimatedHeight(const MessageLayoutKey &key);
+
+    // Asynchronous layout, see MessageLayoutEngine
+    // computes a layout without modifying this object, can be called from any thread. the flags
+    // of the message are read on the gui thread before, they are changed by moderation events.
+    std::unique_ptr<MessageLayoutContainer> computeLayout(const MessageLayoutKey &key,
+                                                          Message::MessageFlags flags) const;
+    // returns false if a layout with the same key is already pending
+    bool setLayoutPending(const MessageLayoutKey &key);
+    // returns false if the layout was dropped because a newer one was requested
+    bool commitPendingLayout(std::unique_ptr<MessageLayoutContainer> container,
+                             const MessageLayoutKey &key);
+    void cancelPendingLayout(const MessageLayoutKey &key);
 
     // Painting
     void paint(QPainter &painter, int y, int messageIndex, Selection &selection,
                bool isLastReadMessage, bool isWindowFocused);
     void invalidateBuffer();
     void deleteBuffer();
+    // adds the gif emotes, they are repainted without the rest of the view
+    void addAnimations(std::vector<VisibleAnimation> &animations, int y) const;
 
     // Elements
     const MessageLayoutElement *getElementAt(QPoint point);
@@ -51,25 +105,21 @@ public:
 private:
     // variables
     MessagePtr message;
-    MessageLayoutContainer container;
-    std::shared_ptr<QPixmap> buffer = nullptr;
+    std::unique_ptr<MessageLayoutContainer> container;
+    std::unique_ptr<QPixmap> buffer;
     bool bufferValid = false;
 
-    int height = 0;
-
-    int currentLayoutWidth = -1;
-    int fontGeneration = -1;
-    int emoteGeneration = -1;
-    QString timestampFormat;
-    float scale = -1;
+    boost::optional<MessageLayoutKey> currentKey;
+    boost::optional<MessageLayoutKey> pendingKey;
+    boost::optional<MessageLayoutKey> estimateKey;
+    std::unique_ptr<MessageLayoutContainer> estimate;
     unsigned int bufferUpdatedCount = 0;
 
-    MessageElement::Flags currentWordFlags = MessageElement::None;
-
     int collapsedHeight = 32;
 
     // methods
-    void actuallyLayout(int width, MessageElement::Flags flags);
+    void commitLayout(std::unique_ptr<MessageLayoutContainer> container,
+                      const MessageLayoutKey &key);
     void updateBuffer(QPixmap *pixmap, int messageIndex, Selection &selection);
 };
 
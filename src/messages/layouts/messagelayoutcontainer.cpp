@@ -1,12 +1,16 @@
 #include "messagelayoutcontainer.hpp"
 
 #include "messagelayoutelement.hpp"
+#include "messages/layouts/animationscheduler.hpp"
+#include "messages/layouts/messagelayout.hpp"
 #include "messages/selection.hpp"
 #include "singletons/settingsmanager.hpp"
 
 #include <QDebug>
 #include <QPainter>
 
+#include <cassert>
+
 #define COMPACT_EMOTES_OFFSET 6
 
 namespace chatterino {
@@ -36,12 +40,21 @@ float MessageLayoutContainer::getScale() const
 }
 
 // methods
-void MessageLayoutContainer::begin(int width, float _scale, Message::MessageFlags _flags)
+void MessageLayoutContainer::begin(int width, float _scale, Message::MessageFlags _flags,
+                                   const MessageLayoutKey &_key)
 {
     this->clear();
     this->width = width;
     this->scale = this->scale;
     this->flags = _flags;
+    this->key = &_key;
+}
+
+const MessageLayoutKey &MessageLayoutContainer::getLayoutKey() const
+{
+    assert(this->key != nullptr);
+
+    return *this->key;
 }
 
 void MessageLayoutContainer::clear()
@@ -150,6 +163,10 @@ void MessageLayoutContainer::breakLine()
 
 bool MessageLayoutContainer::atStartOfLine()
 {
+    if (this->estimatingHeight) {
+        return this->currentX == 0 && this->lineHeight == 0;
+    }
+
     return this->lineStart == this->elements.size();
 }
 
@@ -170,6 +187,116 @@ void MessageLayoutContainer::finish()
         this->lines.back().endIndex = this->elements.size();
         this->lines.back().endCharIndex = this->charIndex;
     }
+
+    this->key = nullptr;
+}
+
+// height estimation
+void MessageLayoutContainer::beginHeightEstimate(int width, float _scale,
+                                                 Message::MessageFlags _flags,
+                                                 const MessageLayoutKey &_key)
+{
+    this->begin(width, _scale, _flags, _key);
+    this->estimatingHeight = true;
+}
+
+bool MessageLayoutContainer::isEstimatingHeight() const
+{
+    return this->estimatingHeight;
+}
+
+void MessageLayoutContainer::addEstimatedElement(const MessageElement &creator, const QSize &size,
+                                                 bool trailingSpace)
+{
+    assert(this->estimatingHeight);
+
+    // top margin
+    if (this->lines.empty() && this->atStartOfLine()) {
+        this->currentY = this->margin.top * this->scale;
+    }
+
+    if (!this->fitsInLine(size.width())) {
+        this->breakLine();
+    }
+
+    int newLineHeight = size.height();
+
+    // compact emote offset
+    bool isCompactEmote = !(this->flags & Message::DisableCompactEmotes) &&
+                          creator.getFlags() & MessageElement::EmoteImages;
+
+    if (isCompactEmote) {
+        newLineHeight -= COMPACT_EMOTES_OFFSET * this->scale;
+    }
+
+    this->lineHeight = std::max(this->lineHeight, newLineHeight);
+
+    this->currentX += size.width();
+
+    if (trailingSpace) {
+        this->currentX += this->spaceWidth;
+    }
+}
+
+// images
+void MessageLayoutContainer::addImageDependency(Image *image)
+{
+    if (!image->hasLoaded()) {
+        this->loadingImages.push_back(image);
+    }
+}
+
+bool MessageLayoutContainer::hasImageChanged() const
+{
+    for (Image *image : this->loadingImages) {
+        if (image->hasLoaded()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// rewrapping
+void MessageLayoutContainer::disableRewrap()
+{
+    this->rewrapEnabled = false;
+}
+
+bool MessageLayoutContainer::canRewrap(int _width) const
+{
+    if (!this->rewrapEnabled) {
+        return false;
+    }
+
+    // elements that don't fit into a line would need to be split
+    int lineWidth = _width - this->margin.left - this->margin.right;
+
+    for (const std::unique_ptr<MessageLayoutElement> &element : this->elements) {
+        if (element->getRect().width() > lineWidth) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MessageLayoutContainer::rewrap(int _width)
+{
+    assert(this->canRewrap(_width));
+
+    std::vector<std::unique_ptr<MessageLayoutElement>> oldElements = std::move(this->elements);
+
+    this->clear();
+    this->width = _width;
+
+    // every element fits into a line, so this breaks the lines exactly like the message
+    // elements did
+    for (std::unique_ptr<MessageLayoutElement> &element : oldElements) {
+        this->addElement(element.release());
+    }
+
+    this->finish();
 }
 
 MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
@@ -198,6 +325,18 @@ void MessageLayoutContainer::paintAnimatedElements(QPainter &painter, int yOffse
     }
 }
 
+void MessageLayoutContainer::addAnimations(std::vector<VisibleAnimation> &animations,
+                                           int yOffset) const
+{
+    for (const std::unique_ptr<MessageLayoutElement> &element : this->elements) {
+        Image *image = element->getAnimatedImage();
+
+        if (image != nullptr) {
+            animations.push_back({image, element->getRect().translated(0, yOffset)});
+        }
+    }
+}
+
 void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
                                             Selection &selection)
 {
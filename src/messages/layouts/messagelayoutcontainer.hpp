@@ -16,6 +16,8 @@ namespace messages {
 
 namespace layouts {
 struct MessageLayoutElement;
+struct MessageLayoutKey;
+struct VisibleAnimation;
 
 struct Margin {
     int top;
@@ -55,8 +57,11 @@ public:
     float getScale() const;
 
     // methods
-    void begin(int width, float scale, Message::MessageFlags flags);
+    // the key has to stay alive until finish is called
+    void begin(int width, float scale, Message::MessageFlags flags, const MessageLayoutKey &key);
     void finish();
+    // the settings the elements are laid out with, only valid between begin and finish
+    const MessageLayoutKey &getLayoutKey() const;
 
     void clear();
     void addElement(MessageLayoutElement *element);
@@ -66,9 +71,31 @@ public:
     bool fitsInLine(int width);
     MessageLayoutElement *getElementAt(QPoint point);
 
+    // images
+    // the message has to be laid out again when an image that was still loading finished
+    void addImageDependency(Image *image);
+    bool hasImageChanged() const;
+
+    // height estimation
+    // only computes the line breaks and the height, no layout elements are created
+    void beginHeightEstimate(int width, float scale, Message::MessageFlags flags,
+                             const MessageLayoutKey &key);
+    bool isEstimatingHeight() const;
+    void addEstimatedElement(const MessageElement &creator, const QSize &size,
+                             bool trailingSpace);
+
+    // rewrapping
+    // words that were split into several lines have to be measured again for a new width
+    void disableRewrap();
+    bool canRewrap(int width) const;
+    // wraps the existing elements into lines for a different width without measuring them again
+    void rewrap(int width);
+
     // painting
     void paintElements(QPainter &painter);
     void paintAnimatedElements(QPainter &painter, int yOffset);
+    // adds the animated images and their rects, see AnimationScheduler
+    void addAnimations(std::vector<VisibleAnimation> &animations, int yOffset) const;
     void paintSelection(QPainter &painter, int messageIndex, Selection &selection);
 
     // selection
@@ -92,6 +119,7 @@ private:
     float scale;
     int width;
     Message::MessageFlags flags;
+    const MessageLayoutKey *key = nullptr;
     int line;
     int height;
     int currentX, currentY;
@@ -99,7 +127,10 @@ private:
     size_t lineStart = 0;
     int lineHeight = 0;
     int spaceWidth = 4;
+    bool rewrapEnabled = true;
+    bool estimatingHeight = false;
     std::vector<std::unique_ptr<MessageLayoutElement>> elements;
+    std::vector<Image *> loadingImages;
 
     std::vector<Line> lines;
 };
@@ -52,6 +52,11 @@ const Link &MessageLayoutElement::getLink() const
     return this->link;
 }
 
+Image *MessageLayoutElement::getAnimatedImage() const
+{
+    return nullptr;
+}
+
 //
 // IMAGE
 //
@@ -98,14 +103,10 @@ void ImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
     }
 
     if (this->image->isAnimated()) {
-        auto pixmap = this->image->getPixmap();
-
-        if (pixmap != nullptr) {
-            // fourtf: make it use qreal values
-            QRect rect = this->getRect();
-            rect.moveTop(rect.y() + yOffset);
-            painter.drawPixmap(QRectF(rect), *pixmap, QRectF());
-        }
+        // fourtf: make it use qreal values
+        QRect rect = this->getRect();
+        rect.moveTop(rect.y() + yOffset);
+        this->image->paintFrame(painter, QRectF(rect));
     }
 }
 
@@ -126,6 +127,15 @@ int ImageLayoutElement::getXFromIndex(int index)
     }
 }
 
+Image *ImageLayoutElement::getAnimatedImage() const
+{
+    if (this->image == nullptr || !this->image->isAnimated()) {
+        return nullptr;
+    }
+
+    return this->image;
+}
+
 //
 // TEXT
 //
@@ -156,12 +166,15 @@ int TextLayoutElement::getSelectionIndexCount()
 
 void TextLayoutElement::paint(QPainter &painter)
 {
+    auto &fontManager = singletons::FontManager::getInstance();
+
     painter.setPen(this->color);
 
-    painter.setFont(singletons::FontManager::getInstance().getFont(this->style, this->scale));
+    painter.setFont(fontManager.getFont(this->style, this->scale));
 
-    painter.drawText(QRectF(this->getRect().x(), this->getRect().y(), 10000, 10000), this->text,
-                     QTextOption(Qt::AlignLeft | Qt::AlignTop));
+    // the static text is shared between all elements with the same word
+    painter.drawStaticText(this->getRect().topLeft(),
+                           fontManager.getStaticText(this->style, this->scale, this->text));
 }
 
 void TextLayoutElement::paintAnimated(QPainter &, int)
@@ -174,7 +187,7 @@ int TextLayoutElement::getMouseOverIndex(const QPoint &abs)
         return 0;
     }
 
-    QFontMetrics &metrics =
+    QFontMetrics metrics =
         singletons::FontManager::getInstance().getFontMetrics(this->style, this->scale);
 
     int x = this->getRect().left();
@@ -194,7 +207,7 @@ int TextLayoutElement::getMouseOverIndex(const QPoint &abs)
 
 int TextLayoutElement::getXFromIndex(int index)
 {
-    QFontMetrics &metrics =
+    QFontMetrics metrics =
         singletons::FontManager::getInstance().getFontMetrics(this->style, this->scale);
 
     if (index <= 0) {
@@ -38,6 +38,8 @@ public:
     virtual void paintAnimated(QPainter &painter, int yOffset) = 0;
     virtual int getMouseOverIndex(const QPoint &abs) = 0;
     virtual int getXFromIndex(int index) = 0;
+    // the image paintAnimated draws, the rect has to be repainted when its frame changes
+    virtual Image *getAnimatedImage() const;
     const Link &getLink() const;
 
 protected:
@@ -62,6 +64,7 @@ protected:
     virtual void paintAnimated(QPainter &painter, int yOffset) override;
     virtual int getMouseOverIndex(const QPoint &abs) override;
     virtual int getXFromIndex(int index) override;
+    virtual Image *getAnimatedImage() const override;
 
 private:
     Image *image;
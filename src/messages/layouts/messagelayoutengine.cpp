@@ -0,0 +1,102 @@
+#include "messages/layouts/messagelayoutengine.hpp"
+#include "util/posttothread.hpp"
+
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+namespace {
+
+struct LayoutBatch {
+    std::vector<MessageLayoutPtr> layouts;
+    // read on the gui thread, moderation events change them
+    std::vector<Message::MessageFlags> messageFlags;
+    std::vector<std::unique_ptr<MessageLayoutContainer>> results;
+    std::atomic<size_t> remainingChunks;
+};
+
+}  // namespace
+
+MessageLayoutEngine::MessageLayoutEngine()
+{
+    // leave a core to the gui thread
+    this->pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+MessageLayoutEngine &MessageLayoutEngine::getInstance()
+{
+    static MessageLayoutEngine instance;
+
+    return instance;
+}
+
+void MessageLayoutEngine::layout(std::vector<MessageLayoutPtr> layouts,
+                                 const MessageLayoutKey &key, std::function<void()> finished)
+{
+    // skip the messages which are already being laid out with the same key
+    layouts.erase(std::remove_if(layouts.begin(), layouts.end(),
+                                 [&key](const MessageLayoutPtr &layout) {
+                                     return !layout->setLayoutPending(key);
+                                 }),
+                  layouts.end());
+
+    if (layouts.empty()) {
+        return;
+    }
+
+    auto batch = std::make_shared<LayoutBatch>();
+    batch->layouts = std::move(layouts);
+    batch->results.resize(batch->layouts.size());
+
+    batch->messageFlags.reserve(batch->layouts.size());
+    for (const MessageLayoutPtr &layout : batch->layouts) {
+        batch->messageFlags.push_back(layout->getMessage()->flags.value);
+    }
+
+    size_t count = batch->layouts.size();
+    size_t chunkCount = std::min(count, (size_t)this->pool.maxThreadCount());
+    batch->remainingChunks = chunkCount;
+
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        size_t begin = count * chunk / chunkCount;
+        size_t end = count * (chunk + 1) / chunkCount;
+
+        this->pool.start(new util::LambdaRunnable([batch, key, finished, begin, end] {
+            for (size_t i = begin; i < end; i++) {
+                batch->results[i] = batch->layouts[i]->computeLayout(key, batch->messageFlags[i]);
+            }
+
+            if (--batch->remainingChunks != 0) {
+                return;
+            }
+
+            // the last chunk hands the results over to the gui thread
+            util::postToThread([batch, key, finished] {
+                // checked once so either all of the layouts are committed or none of them
+                bool outdated = key.isOutdated();
+
+                for (size_t i = 0; i < batch->layouts.size(); i++) {
+                    if (outdated) {
+                        batch->layouts[i]->cancelPendingLayout(key);
+                    } else {
+                        batch->layouts[i]->commitPendingLayout(std::move(batch->results[i]), key);
+                    }
+                }
+
+                // layouts own pixmaps, so they must not be destroyed on a worker thread
+                batch->layouts.clear();
+
+                finished();
+            });
+        }));
+    }
+}
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "messages/layouts/messagelayout.hpp"
+
+#include <QThreadPool>
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+// Lays out messages on a pool of worker threads, only painting is left to the gui thread.
+class MessageLayoutEngine : boost::noncopyable
+{
+    MessageLayoutEngine();
+
+public:
+    static MessageLayoutEngine &getInstance();
+
+    // Computes the layouts on the worker threads and commits all of them together on the gui
+    // thread. They are dropped if the fonts, emotes or timestamp format changed in the meantime
+    // or if a newer layout was requested. finished is called on the gui thread afterwards.
+    void layout(std::vector<MessageLayoutPtr> layouts, const MessageLayoutKey &key,
+                std::function<void()> finished);
+
+private:
+    QThreadPool pool;
+};
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
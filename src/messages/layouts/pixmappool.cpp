@@ -0,0 +1,106 @@
+#include "messages/layouts/pixmappool.hpp"
+#include "singletons/settingsmanager.hpp"
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+namespace {
+
+const int BUCKET_WIDTH_STEP = 64;
+const int BUCKET_HEIGHT_STEP = 32;
+
+size_t getMaxMemoryUsage()
+{
+    int megabytes = singletons::SettingManager::getInstance().messageBufferMemory.getValue();
+
+    return (size_t)std::max(0, megabytes) * 1024 * 1024;
+}
+
+}  // namespace
+
+PixmapPool::PixmapPool()
+{
+    singletons::SettingManager::getInstance().messageBufferMemory.connect(
+        [this](auto, auto) { this->trim(getMaxMemoryUsage()); });
+}
+
+PixmapPool &PixmapPool::getInstance()
+{
+    static PixmapPool instance;
+
+    return instance;
+}
+
+QSize PixmapPool::getBucketSize(const QSize &size)
+{
+    auto roundUp = [](int value, int step) {
+        return std::max(1, (value + step - 1) / step) * step;  //
+    };
+
+    return QSize(roundUp(size.width(), BUCKET_WIDTH_STEP),
+                 roundUp(size.height(), BUCKET_HEIGHT_STEP));
+}
+
+std::unique_ptr<QPixmap> PixmapPool::take(const QSize &size, qreal devicePixelRatio)
+{
+    QSize bucketSize = PixmapPool::getBucketSize(size);
+
+    auto it =
+        this->buckets.find(BucketKey(bucketSize.width(), bucketSize.height(), devicePixelRatio));
+
+    if (it != this->buckets.end() && !it->second.empty()) {
+        std::unique_ptr<QPixmap> pixmap = std::move(it->second.back());
+        it->second.pop_back();
+
+        this->memoryUsage -= PixmapPool::getMemoryUsage(*pixmap);
+
+        return pixmap;
+    }
+
+    std::unique_ptr<QPixmap> pixmap(new QPixmap(bucketSize));
+    pixmap->setDevicePixelRatio(devicePixelRatio);
+
+    return pixmap;
+}
+
+void PixmapPool::giveBack(std::unique_ptr<QPixmap> pixmap)
+{
+    size_t pixmapMemoryUsage = PixmapPool::getMemoryUsage(*pixmap);
+    size_t maxMemoryUsage = getMaxMemoryUsage();
+
+    if (pixmapMemoryUsage > maxMemoryUsage) {
+        return;
+    }
+
+    this->trim(maxMemoryUsage - pixmapMemoryUsage);
+
+    BucketKey key(pixmap->width(), pixmap->height(), pixmap->devicePixelRatio());
+
+    this->buckets[key].push_back(std::move(pixmap));
+    this->memoryUsage += pixmapMemoryUsage;
+}
+
+size_t PixmapPool::getMemoryUsage(const QPixmap &pixmap)
+{
+    return (size_t)pixmap.width() * pixmap.height() * std::max(1, pixmap.depth() / 8);
+}
+
+void PixmapPool::trim(size_t maxMemoryUsage)
+{
+    // the biggest pixmaps are dropped first, they are the least likely to be reused
+    auto it = this->buckets.end();
+
+    while (this->memoryUsage > maxMemoryUsage && it != this->buckets.begin()) {
+        --it;
+
+        while (this->memoryUsage > maxMemoryUsage && !it->second.empty()) {
+            this->memoryUsage -= PixmapPool::getMemoryUsage(*it->second.back());
+            it->second.pop_back();
+        }
+    }
+}
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QPixmap>
+#include <QSize>
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+namespace layouts {
+
+// Keeps the buffers of messages that scrolled out of view, so scrolling reuses them instead of
+// allocating a new pixmap for every message that becomes visible. Pixmaps are grouped into
+// buckets by their size rounded up. Only use it on the gui thread.
+class PixmapPool : boost::noncopyable
+{
+    PixmapPool();
+
+public:
+    static PixmapPool &getInstance();
+
+    // size of the pixmaps that are handed out for the size in device pixels
+    static QSize getBucketSize(const QSize &size);
+
+    // returns a pixmap of the bucket size for the size in device pixels
+    std::unique_ptr<QPixmap> take(const QSize &size, qreal devicePixelRatio);
+    void giveBack(std::unique_ptr<QPixmap> pixmap);
+
+private:
+    typedef std::tuple<int, int, qreal> BucketKey;
+
+    std::map<BucketKey, std::vector<std::unique_ptr<QPixmap>>> buckets;
+    size_t memoryUsage = 0;
+
+    static size_t getMemoryUsage(const QPixmap &pixmap);
+
+    void trim(size_t maxMemoryUsage);
+};
+
+}  // namespace layouts
+}  // namespace messages
+}  // namespace chatterino
@@ -4,8 +4,10 @@
 
 #include "messages/limitedqueuesnapshot.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace chatterino {
@@ -20,9 +22,22 @@ namespace messages {
 // - when the limit is reached for every message added one will be removed at the start
 // - messages can only be added to the start when there is space for them,
 //   trying to add messages to the start when it's full will not add them
+// - the limit can be changed at any time, lowering it removes messages at the start
 // - you are able to get a "Snapshot" which captures the state of this object
 // - adding items to this class does not change the "items" of the snapshot
 //
+// Implementation:
+// - items live in a ring of fixed-size chunks, 'begin' and 'end' are absolute positions that
+//   only move forward while appending, a slot is written once and never changed afterwards
+// - positions start in the middle of the range of size_t so pushFront never runs out of room,
+//   no matter how often the limit is raised
+// - chunks that only contain removed items are dropped when a new chunk is appended, snapshots
+//   that still use them keep them alive
+// - all modifying methods must be called from the same thread (single producer), they never
+//   wait for anything
+// - every modification increments 'epoch' before and after changing the state, getSnapshot
+//   retries until it read the state without a modification in between, so readers never lock
+//
 
 template <typename T>
 class LimitedQueue
@@ -40,49 +55,65 @@ public:
 
     void clear()
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
-
-        this->chunks = std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
-        Chunk chunk = std::make_shared<std::vector<T>>();
-        chunk->resize(this->chunkSize);
-        this->chunks->push_back(chunk);
-        this->firstChunkOffset = 0;
-        this->lastChunkEnd = 0;
+        this->beginWrite();
+
+        // leave enough room in front of the first position for pushFront
+        size_t baseChunk = SIZE_MAX / 2 / this->chunkSize;
+
+        ChunkVector newChunks = std::make_shared<std::vector<Chunk>>();
+        newChunks->push_back(this->createChunk());
+
+        std::atomic_store(&this->chunks, newChunks);
+        this->firstChunk.store(baseChunk);
+        this->begin.store(baseChunk * this->chunkSize);
+        this->end.store(baseChunk * this->chunkSize);
+        this->lowestBegin = baseChunk * this->chunkSize;
+
+        this->endWrite();
     }
 
     // return true if an item was deleted
     // deleted will be set if the item was deleted
     bool pushBack(const T &item, T &deleted)
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        this->beginWrite();
 
-        Chunk lastChunk = this->chunks->back();
+        size_t begin = this->begin.load();
+        size_t end = this->end.load();
+        size_t first = this->firstChunk.load();
+        ChunkVector chunks = this->chunks;
 
-        // still space in the last chunk
-        if (lastChunk->size() <= this->lastChunkEnd) {
-            // create new chunk vector
-            ChunkVector newVector =
-                std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
+        // no space left in the last chunk
+        if (end == (first + chunks->size()) * this->chunkSize) {
+            // drop the chunks that only contain deleted items and append a new one
+            size_t dropCount = begin / this->chunkSize - first;
 
-            // copy chunks
-            for (Chunk &chunk : *this->chunks) {
-                newVector->push_back(chunk);
-            }
+            ChunkVector newChunks = std::make_shared<std::vector<Chunk>>(
+                chunks->begin() + dropCount, chunks->end());
+            newChunks->push_back(this->createChunk());
 
-            // push back new chunk
-            Chunk newChunk = std::make_shared<std::vector<T>>();
-            newChunk->resize(this->chunkSize);
-            newVector->push_back(newChunk);
+            std::atomic_store(&this->chunks, newChunks);
+            this->firstChunk.store(first + dropCount);
 
-            // replace current chunk vector
-            this->chunks = newVector;
-            this->lastChunkEnd = 0;
-            lastChunk = this->chunks->back();
+            chunks = newChunks;
+            first += dropCount;
         }
 
-        lastChunk->at(this->lastChunkEnd++) = item;
+        this->slot(*chunks, first, end) = item;
+        this->end.store(++end);
 
-        return this->deleteFirstItem(deleted);
+        // remove the first item if the limit is exceeded
+        bool deletedItem = false;
+
+        if (end - begin > this->limit) {
+            deleted = this->slot(*chunks, first, begin);
+            this->begin.store(begin + 1);
+            deletedItem = true;
+        }
+
+        this->endWrite();
+
+        return deletedItem;
     }
 
     // returns a vector with all the accepted items
@@ -90,76 +121,130 @@ public:
     {
         std::vector<T> acceptedItems;
 
-        if (this->space() > 0) {
-            std::lock_guard<std::mutex> lock(this->mutex);
+        this->beginWrite();
 
-            // create new vector to clone chunks into
-            ChunkVector newChunks =
-                std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
+        size_t begin = this->begin.load();
+        size_t end = this->end.load();
+        size_t first = this->firstChunk.load();
+        ChunkVector chunks = this->chunks;
 
-            newChunks->resize(this->chunks->size());
+        size_t length = end - begin;
+        size_t count = length < this->limit ? std::min(this->limit - length, items.size()) : 0;
+        size_t newBegin = begin - count;
 
-            // copy chunks except for first one
-            for (size_t i = 1; i < this->chunks->size(); i++) {
-                newChunks->at(i) = this->chunks->at(i);
-            }
+        if (count == 0) {
+            this->endWrite();
+            return acceptedItems;
+        }
 
-            // create new chunk for the first one
-            size_t offset = std::min(this->space(), items.size());
-            Chunk newFirstChunk = std::make_shared<std::vector<T>>();
-            newFirstChunk->resize(this->chunks->front()->size() + offset);
+        // prepend chunks for the items that don't fit in front of the first chunk
+        size_t newChunkCount = 0;
+        if (newBegin < first * this->chunkSize) {
+            newChunkCount =
+                (first * this->chunkSize - newBegin + this->chunkSize - 1) / this->chunkSize;
+        }
 
-            for (size_t i = 0; i < offset; i++) {
-                newFirstChunk->at(i) = items[items.size() - offset + i];
-                acceptedItems.push_back(items[items.size() - offset + i]);
-            }
+        ChunkVector newChunks = std::make_shared<std::vector<Chunk>>();
+        newChunks->reserve(newChunkCount + chunks->size());
 
-            for (size_t i = 0; i < this->chunks->at(0)->size(); i++) {
-                newFirstChunk->at(i + offset) = this->chunks->at(0)->at(i);
-            }
+        for (size_t i = 0; i < newChunkCount; i++) {
+            newChunks->push_back(this->createChunk());
+        }
+        newChunks->insert(newChunks->end(), chunks->begin(), chunks->end());
 
-            newChunks->at(0) = newFirstChunk;
+        first -= newChunkCount;
 
-            this->chunks = newChunks;
-            // qDebug() << acceptedItems.size();
-            // qDebug() << this->chunks->at(0)->size();
+        // slots in front of 'begin' that were visible before the items were removed with popFront
+        // or setLimit might still be used by a snapshot, the chunks containing them are copied
+        size_t visibleBegin = std::max(newBegin, this->lowestBegin);
 
-            if (this->chunks->size() == 1) {
-                this->lastChunkEnd += offset;
+        if (visibleBegin < begin) {
+            for (size_t chunk = visibleBegin / this->chunkSize;
+                 chunk <= (begin - 1) / this->chunkSize; chunk++) {
+                Chunk &item = newChunks->at(chunk - first);
+                item = std::make_shared<std::vector<T>>(*item);
             }
         }
 
+        // all other slots in front of 'begin' have never been visible to a snapshot
+        for (size_t i = 0; i < count; i++) {
+            const T &item = items[items.size() - count + i];
+
+            this->slot(*newChunks, first, newBegin + i) = item;
+            acceptedItems.push_back(item);
+        }
+
+        std::atomic_store(&this->chunks, newChunks);
+        this->firstChunk.store(first);
+        this->lowestBegin = std::min(this->lowestBegin, newBegin);
+        this->begin.store(newBegin);
+
+        this->endWrite();
+
         return acceptedItems;
     }
 
-    // replace an single item, return index if successful, -1 if unsuccessful
-    int replaceItem(const T &item, const T &replacement)
+    // return true if an item was removed
+    // deleted will be set to the first item if it was removed
+    bool popFront(T &deleted)
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        size_t begin = this->begin.load();
 
-        int x = 0;
+        if (begin == this->end.load()) {
+            return false;
+        }
+
+        this->beginWrite();
+
+        deleted = this->slot(*this->chunks, this->firstChunk.load(), begin);
+        this->begin.store(begin + 1);
+
+        this->endWrite();
+
+        return true;
+    }
 
-        for (size_t i = 0; i < this->chunks->size(); i++) {
-            Chunk &chunk = this->chunks->at(i);
+    // changes the limit, returns the items that were removed at the start in order
+    std::vector<T> setLimit(size_t newLimit)
+    {
+        std::vector<T> deletedItems;
 
-            size_t start = i == 0 ? this->firstChunkOffset : 0;
-            size_t end = i == chunk->size() - 1 ? this->lastChunkEnd : chunk->size();
+        this->limit = newLimit;
 
-            for (size_t j = start; j < end; j++) {
-                if (chunk->at(j) == item) {
-                    Chunk newChunk = std::make_shared<std::vector<T>>();
-                    newChunk->resize(chunk->size());
+        T deleted;
+        while (this->getLength() > this->limit && this->popFront(deleted)) {
+            deletedItems.push_back(deleted);
+        }
 
-                    for (size_t k = 0; k < chunk->size(); k++) {
-                        newChunk->at(k) = chunk->at(k);
-                    }
+        if (!deletedItems.empty()) {
+            this->dropDeletedChunks();
+        }
 
-                    newChunk->at(j) = replacement;
-                    this->chunks->at(i) = newChunk;
+        return deletedItems;
+    }
 
-                    return x;
-                }
-                x++;
+    size_t getLimit() const
+    {
+        return this->limit;
+    }
+
+    size_t getLength() const
+    {
+        return this->end.load() - this->begin.load();
+    }
+
+    // replace an single item, return index if successful, -1 if unsuccessful
+    int replaceItem(const T &item, const T &replacement)
+    {
+        size_t begin = this->begin.load();
+        size_t end = this->end.load();
+        size_t first = this->firstChunk.load();
+
+        for (size_t position = begin; position < end; position++) {
+            if (this->slot(*this->chunks, first, position) == item) {
+                this->replaceAt(position, &replacement, 1);
+
+                return (int)(position - begin);
             }
         }
 
@@ -169,101 +254,157 @@ public:
     // replace an item at index, return true if worked
     bool replaceItem(size_t index, const T &replacement)
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
-
-        size_t x = 0;
+        size_t begin = this->begin.load();
 
-        for (size_t i = 0; i < this->chunks->size(); i++) {
-            Chunk &chunk = this->chunks->at(i);
+        if (index >= this->end.load() - begin) {
+            return false;
+        }
 
-            size_t start = i == 0 ? this->firstChunkOffset : 0;
-            size_t end = i == chunk->size() - 1 ? this->lastChunkEnd : chunk->size();
+        this->replaceAt(begin + index, &replacement, 1);
 
-            for (size_t j = start; j < end; j++) {
-                if (x == index) {
-                    Chunk newChunk = std::make_shared<std::vector<T>>();
-                    newChunk->resize(chunk->size());
+        return true;
+    }
 
-                    for (size_t k = 0; k < chunk->size(); k++) {
-                        newChunk->at(k) = chunk->at(k);
-                    }
+    // replace the items starting at index, return true if worked
+    // every chunk that contains one of the items is only copied once
+    bool replaceRange(size_t index, const std::vector<T> &replacements)
+    {
+        size_t begin = this->begin.load();
 
-                    newChunk->at(j) = replacement;
-                    this->chunks->at(i) = newChunk;
+        if (index + replacements.size() > this->end.load() - begin) {
+            return false;
+        }
 
-                    return true;
-                }
-                x++;
-            }
+        if (!replacements.empty()) {
+            this->replaceAt(begin + index, replacements.data(), replacements.size());
         }
-        return false;
+
+        return true;
+    }
+
+    // an item keeps its position while it is in the queue, unlike its index the position can be
+    // stored to find the item again later
+    // index = position - getFirstPosition()
+    size_t getFirstPosition() const
+    {
+        return this->begin.load();
+    }
+
+    size_t getEndPosition() const
+    {
+        return this->end.load();
     }
 
     //    void insertAfter(const std::vector<T> &items, const T &index)
 
-    messages::LimitedQueueSnapshot<T> getSnapshot()
+    messages::LimitedQueueSnapshot<T> getSnapshot() const
     {
-        std::lock_guard<std::mutex> lock(this->mutex);
+        while (true) {
+            size_t epochBefore = this->epoch.load();
+
+            // a modification is in progress on the producer thread
+            if (epochBefore & 1) {
+                std::this_thread::yield();
+                continue;
+            }
 
-        return LimitedQueueSnapshot<T>(this->chunks, this->limit - this->space(),
-                                       this->firstChunkOffset, this->lastChunkEnd);
+            ChunkVector chunks = std::atomic_load(&this->chunks);
+            size_t first = this->firstChunk.load();
+            size_t begin = this->begin.load();
+            size_t end = this->end.load();
+
+            if (this->epoch.load() == epochBefore) {
+                return LimitedQueueSnapshot<T>(chunks, end - begin,
+                                               begin - first * this->chunkSize, this->chunkSize);
+            }
+        }
     }
 
 private:
-    size_t space()
+    Chunk createChunk() const
     {
-        size_t totalSize = 0;
-        for (Chunk &chunk : *this->chunks) {
-            totalSize += chunk->size();
-        }
+        return std::make_shared<std::vector<T>>(this->chunkSize);
+    }
 
-        totalSize -= this->chunks->back()->size() - this->lastChunkEnd;
-        if (this->chunks->size() != 1) {
-            totalSize -= this->firstChunkOffset;
-        }
+    T &slot(const std::vector<Chunk> &chunks, size_t first, size_t position) const
+    {
+        position -= first * this->chunkSize;
 
-        return this->limit - totalSize;
+        return chunks.at(position / this->chunkSize)->at(position % this->chunkSize);
     }
 
-    bool deleteFirstItem(T &deleted)
+    // releases the chunks that only contain removed items
+    void dropDeletedChunks()
     {
-        // determine if the first chunk should be deleted
-        if (space() > 0) {
-            return false;
+        size_t first = this->firstChunk.load();
+        size_t dropCount = this->begin.load() / this->chunkSize - first;
+
+        // the last chunk is kept for the next pushBack
+        dropCount = std::min(dropCount, this->chunks->size() - 1);
+
+        if (dropCount == 0) {
+            return;
         }
 
-        deleted = this->chunks->front()->at(this->firstChunkOffset);
+        this->beginWrite();
+
+        ChunkVector newChunks = std::make_shared<std::vector<Chunk>>(
+            this->chunks->begin() + dropCount, this->chunks->end());
+
+        std::atomic_store(&this->chunks, newChunks);
+        this->firstChunk.store(first + dropCount);
+
+        this->endWrite();
+    }
+
+    // copies the chunk vector and the chunks that contain the items so existing snapshots are not
+    // modified
+    void replaceAt(size_t position, const T *replacements, size_t count)
+    {
+        this->beginWrite();
+
+        size_t first = this->firstChunk.load();
 
-        this->firstChunkOffset++;
+        ChunkVector newChunks = std::make_shared<std::vector<Chunk>>(*this->chunks);
 
-        // need to delete the first chunk
-        if (this->firstChunkOffset == this->chunks->front()->size() - 1) {
-            // copy the chunk vector
-            ChunkVector newVector =
-                std::make_shared<std::vector<std::shared_ptr<std::vector<T>>>>();
+        for (size_t i = 0; i < count; i++) {
+            size_t chunkIndex = (position + i) / this->chunkSize - first;
 
-            // delete first chunk
-            bool first = true;
-            for (Chunk &chunk : *this->chunks) {
-                if (!first) {
-                    newVector->push_back(chunk);
-                }
-                first = false;
+            // the first item in this range that is in the chunk
+            if (i == 0 || (position + i) % this->chunkSize == 0) {
+                Chunk &chunk = newChunks->at(chunkIndex);
+                chunk = std::make_shared<std::vector<T>>(*chunk);
             }
 
-            this->chunks = newVector;
-            this->firstChunkOffset = 0;
+            newChunks->at(chunkIndex)->at((position + i) % this->chunkSize) = replacements[i];
         }
-        return true;
+
+        std::atomic_store(&this->chunks, newChunks);
+
+        this->endWrite();
+    }
+
+    void beginWrite()
+    {
+        this->epoch.fetch_add(1);
     }
 
+    void endWrite()
+    {
+        this->epoch.fetch_add(1);
+    }
+
+    // only written by the producer thread with std::atomic_store
     ChunkVector chunks;
-    std::mutex mutex;
 
-    size_t firstChunkOffset;
-    size_t lastChunkEnd;
-    size_t limit;
+    std::atomic<size_t> epoch{0};
+    std::atomic<size_t> firstChunk{0};
+    std::atomic<size_t> begin{0};
+    std::atomic<size_t> end{0};
 
+    // only used by the producer thread
+    size_t limit;
+    size_t lowestBegin = 0;
     const size_t chunkSize = 100;
 };
 
@@ -1,61 +1,182 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <vector>
 
 namespace chatterino {
 namespace messages {
 
+//
+// Explanation:
+// - every chunk has the same size, so an index can be mapped to a chunk and an offset with a
+//   single division instead of walking the chunk vector
+// - iterators keep track of the current chunk, use them for loops over many items
+//
+
 template <typename T>
 class LimitedQueueSnapshot
 {
+    typedef std::shared_ptr<std::vector<T>> Chunk;
+    typedef std::shared_ptr<std::vector<Chunk>> ChunkVector;
+
 public:
+    class Iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Iterator()
+            : chunks(nullptr)
+            , chunkIndex(0)
+            , offset(0)
+            , chunkSize(1)
+        {
+        }
+
+        Iterator(const std::vector<Chunk> *_chunks, size_t position, size_t _chunkSize)
+            : chunks(_chunks)
+            , chunkIndex(position / _chunkSize)
+            , offset(position % _chunkSize)
+            , chunkSize(_chunkSize)
+        {
+        }
+
+        reference operator*() const
+        {
+            return (*this->chunks)[this->chunkIndex]->at(this->offset);
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        Iterator &operator++()
+        {
+            if (++this->offset == this->chunkSize) {
+                this->offset = 0;
+                this->chunkIndex++;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        Iterator &operator--()
+        {
+            if (this->offset == 0) {
+                this->offset = this->chunkSize;
+                this->chunkIndex--;
+            }
+            this->offset--;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            Iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return this->chunkIndex == other.chunkIndex && this->offset == other.offset;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const std::vector<Chunk> *chunks;
+        size_t chunkIndex;
+        size_t offset;
+        size_t chunkSize;
+    };
+
+    typedef Iterator const_iterator;
+    typedef std::reverse_iterator<Iterator> const_reverse_iterator;
+
     LimitedQueueSnapshot()
         : length(0)
+        , firstChunkOffset(0)
+        , chunkSize(1)
     {
     }
 
-    LimitedQueueSnapshot(std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> _chunks,
-                         size_t _length, size_t _firstChunkOffset, size_t _lastChunkEnd)
+    LimitedQueueSnapshot(ChunkVector _chunks, size_t _length, size_t _firstChunkOffset,
+                         size_t _chunkSize)
         : chunks(_chunks)
         , length(_length)
         , firstChunkOffset(_firstChunkOffset)
-        , lastChunkEnd(_lastChunkEnd)
+        , chunkSize(_chunkSize)
     {
+        assert(_chunkSize > 0);
     }
 
-    std::size_t getLength()
+    std::size_t getLength() const
     {
         return this->length;
     }
 
     T const &operator[](std::size_t index) const
     {
+        assert(index < this->length && "out of range");
+
         index += this->firstChunkOffset;
 
-        size_t x = 0;
+        return this->chunks->at(index / this->chunkSize)->at(index % this->chunkSize);
+    }
 
-        for (size_t i = 0; i < this->chunks->size(); i++) {
-            auto &chunk = this->chunks->at(i);
+    // returns an iterator pointing to the item at index
+    const_iterator iteratorAt(std::size_t index) const
+    {
+        assert(index <= this->length && "out of range");
 
-            if (x <= index && x + chunk->size() > index) {
-                return chunk->at(index - x);
-            }
-            x += chunk->size();
-        }
+        return const_iterator(this->chunks.get(), this->firstChunkOffset + index,
+                              this->chunkSize);
+    }
+
+    const_iterator begin() const
+    {
+        return this->iteratorAt(0);
+    }
+
+    const_iterator end() const
+    {
+        return this->iteratorAt(this->length);
+    }
 
-        assert(false && "out of range");
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(this->end());
+    }
 
-        return this->chunks->at(0)->at(0);
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(this->begin());
     }
 
 private:
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> chunks;
+    ChunkVector chunks;
 
     size_t length;
     size_t firstChunkOffset;
-    size_t lastChunkEnd;
+    size_t chunkSize;
 };
 
 }  // namespace messages
@@ -1,17 +1,21 @@
 #include "messages/message.hpp"
 #include "messageelement.hpp"
 #include "util/irchelpers.hpp"
+#include "util/stringinterner.hpp"
 
 typedef chatterino::widgets::ScrollbarHighlight SBHighlight;
 
 namespace chatterino {
 namespace messages {
-void Message::addElement(MessageElement *element)
+Message::~Message()
 {
-    this->elements.push_back(std::unique_ptr<MessageElement>(element));
+    // the arena only frees the memory
+    for (auto it = this->elements.rbegin(); it != this->elements.rend(); ++it) {
+        (*it)->~MessageElement();
+    }
 }
 
-const std::vector<std::unique_ptr<MessageElement>> &Message::getElements() const
+const std::vector<MessageElement *> &Message::getElements() const
 {
     return this->elements;
 }
@@ -24,15 +28,37 @@ SBHighlight Message::getScrollBarHighlight() const
     return SBHighlight();
 }
 
+QString Message::getSearchText() const
+{
+    if (this->loginName.isEmpty()) {
+        return this->messageText;
+    }
+
+    return this->loginName + ": " + this->messageText;
+}
+
+size_t Message::getEstimatedSize() const
+{
+    size_t size = sizeof(Message);
+
+    // the names are interned and shared with other messages
+    size += (this->id.size() + this->messageText.size()) * sizeof(QChar);
+
+    // elements and their layout elements vary in size, this is about the average
+    size += this->elements.size() * 160;
+
+    return size;
+}
+
 // Static
 MessagePtr Message::createSystemMessage(const QString &text)
 {
     MessagePtr message(new Message);
 
-    message->addElement(new TimestampElement(QTime::currentTime()));
-    message->addElement(new TextElement(text, MessageElement::Text, MessageColor::System));
+    message->emplaceElement<TimestampElement>(QTime::currentTime());
+    message->emplaceElement<TextElement>(text, MessageElement::Text, MessageColor::System);
     message->flags |= MessageFlags::System;
-    message->searchText = text;
+    message->messageText = text;
 
     return message;
 }
@@ -73,7 +99,8 @@ MessagePtr Message::createTimeoutMessage(const QString &username, const QString
 
     MessagePtr message = Message::createSystemMessage(text);
     message->flags |= MessageFlags::System;
-    message->timeoutUser = username;
+    message->flags |= MessageFlags::Timeout;
+    message->timeoutUser = util::StringInterner::getInstance().intern(username);
     return message;
 }
 
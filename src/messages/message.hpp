@@ -1,18 +1,25 @@
 #pragma once
 
 #include "messages/messageelement.hpp"
+#include "util/arena.hpp"
 #include "util/flagsenum.hpp"
 #include "widgets/helper/scrollbarhighlight.hpp"
 
 #include <cinttypes>
 #include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <QTime>
+#include <boost/noncopyable.hpp>
 
 namespace chatterino {
 namespace messages {
-struct Message {
+struct Message : boost::noncopyable {
+    ~Message();
+
     enum MessageFlags : uint16_t {
         None = 0,
         System = (1 << 0),
@@ -29,21 +36,43 @@ struct Message {
     util::FlagsEnum<MessageFlags> flags;
     QTime parseTime;
     QString id;
-    QString searchText;
+    // text of the message without the name of the sender
+    QString messageText;
     QString loginName;
     QString displayName;
     QString localizedName;
     QString timeoutUser;
 
-    // Messages should not be added after the message is done initializing.
-    void addElement(MessageElement *element);
-    const std::vector<std::unique_ptr<MessageElement>> &getElements() const;
+    // Elements cache measurements while they are laid out, layouts are computed on worker
+    // threads so a message is only laid out by one of them at a time.
+    std::mutex layoutMutex;
+
+    // Elements should not be added after the message is done initializing.
+    // They are allocated in the arena of the message and live as long as the message does.
+    template <typename T, typename... Args>
+    T *emplaceElement(Args &&... args)
+    {
+        static_assert(std::is_base_of<MessageElement, T>::value, "T must extend MessageElement");
+
+        T *element = this->arena.create<T>(std::forward<Args>(args)...);
+        this->elements.push_back(element);
+        return element;
+    }
+
+    const std::vector<MessageElement *> &getElements() const;
 
     // Scrollbar
     widgets::ScrollbarHighlight getScrollBarHighlight() const;
 
+    // Text that is searched and logged, "loginName: messageText" for messages sent by a user
+    QString getSearchText() const;
+
+    // Rough amount of memory used by the message and the layouts created for it
+    size_t getEstimatedSize() const;
+
 private:
-    std::vector<std::unique_ptr<MessageElement>> elements;
+    util::Arena arena;
+    std::vector<MessageElement *> elements;
 
 public:
     static std::shared_ptr<Message> createSystemMessage(const QString &text);
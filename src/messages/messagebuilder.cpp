@@ -18,11 +18,6 @@ MessagePtr MessageBuilder::getMessage()
     return this->message;
 }
 
-void MessageBuilder::append(MessageElement *element)
-{
-    this->message->addElement(element);
-}
-
 void MessageBuilder::appendTimestamp()
 {
     this->appendTimestamp(QTime::currentTime());
@@ -39,7 +34,7 @@ void MessageBuilder::setHighlight(bool value)
 
 void MessageBuilder::appendTimestamp(const QTime &time)
 {
-    this->append(new TimestampElement(time));
+    this->emplace<TimestampElement>(time);
 }
 
 QString MessageBuilder::matchLink(const QString &string)
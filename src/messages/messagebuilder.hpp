@@ -16,7 +16,6 @@ public:
     MessagePtr getMessage();
 
     void setHighlight(bool value);
-    void append(MessageElement *element);
     void appendTimestamp();
     void appendTimestamp(const QTime &time);
     QString matchLink(const QString &string);
@@ -26,9 +25,7 @@ public:
     {
         static_assert(std::is_base_of<MessageElement, T>::value, "T must extend MessageElement");
 
-        T *element = new T(std::forward<Args>(args)...);
-        this->append(element);
-        return element;
+        return this->message->emplaceElement<T>(std::forward<Args>(args)...);
     }
 
 protected:
@@ -13,17 +13,17 @@ MessageColor::MessageColor(Type _type)
 {
 }
 
-const QColor &MessageColor::getColor(singletons::ThemeManager &themeManager) const
+const QColor &MessageColor::getColor(const singletons::ThemeManager::MessageColors &colors) const
 {
     switch (this->type) {
         case Type::Custom:
             return this->customColor;
         case Type::Text:
-            return themeManager.messages.textColors.regular;
+            return colors.regular;
         case Type::System:
-            return themeManager.messages.textColors.system;
+            return colors.system;
         case Type::Link:
-            return themeManager.messages.textColors.link;
+            return colors.link;
     }
 
     static QColor _default;
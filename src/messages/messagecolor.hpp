@@ -12,7 +12,7 @@ struct MessageColor {
     MessageColor(const QColor &color);
     MessageColor(Type type = Text);
 
-    const QColor &getColor(singletons::ThemeManager &themeManager) const;
+    const QColor &getColor(const singletons::ThemeManager::MessageColors &colors) const;
 
 private:
     Type type;
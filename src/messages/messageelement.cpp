@@ -1,13 +1,24 @@
 #include "messages/messageelement.hpp"
+#include "messages/layouts/messagelayout.hpp"
 #include "messages/layouts/messagelayoutcontainer.hpp"
 #include "messages/layouts/messagelayoutelement.hpp"
-#include "singletons/settingsmanager.hpp"
 #include "util/benchmark.hpp"
 #include "util/emotemap.hpp"
+#include "util/wordwrap.hpp"
 
 namespace chatterino {
 namespace messages {
 
+namespace {
+
+// the characters the ref points to as a QString for QFontMetrics, they aren't copied
+QString rawString(const QStringRef &ref)
+{
+    return QString::fromRawData(ref.unicode(), ref.size());
+}
+
+}  // namespace
+
 MessageElement::MessageElement(Flags _flags)
     : flags(_flags)
 {
@@ -65,6 +76,13 @@ void ImageElement::addToContainer(MessageLayoutContainer &container, MessageElem
         QSize size(this->image->getWidth() * this->image->getScale() * container.getScale(),
                    this->image->getHeight() * this->image->getScale() * container.getScale());
 
+        container.addImageDependency(this->image);
+
+        if (container.isEstimatingHeight()) {
+            container.addEstimatedElement(*this, size, this->hasTrailingSpace());
+            return;
+        }
+
         container.addElement(
             (new ImageLayoutElement(*this, this->image, size))->setLink(this->getLink()));
     }
@@ -74,18 +92,10 @@ void ImageElement::addToContainer(MessageLayoutContainer &container, MessageElem
 EmoteElement::EmoteElement(const util::EmoteData &_data, MessageElement::Flags flags)
     : MessageElement(flags)
     , data(_data)
-    , textElement(nullptr)
 {
     if (_data.isValid()) {
         this->setTooltip(data.image1x->getTooltip());
-        this->textElement = new TextElement(_data.image1x->getName(), MessageElement::Misc);
-    }
-}
-
-EmoteElement::~EmoteElement()
-{
-    if (this->textElement != nullptr) {
-        delete this->textElement;
+        this->textElement.emplace(_data.image1x->getName(), MessageElement::Misc);
     }
 }
 
@@ -97,7 +107,7 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container, MessageElem
                 return;
             }
 
-            int quality = singletons::SettingManager::getInstance().preferredEmoteQuality;
+            int quality = container.getLayoutKey().emoteQuality;
 
             Image *_image;
             if (quality == 3 && this->data.image3x != nullptr) {
@@ -111,10 +121,17 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container, MessageElem
             QSize size((int)(container.getScale() * _image->getScaledWidth()),
                        (int)(container.getScale() * _image->getScaledHeight()));
 
+            container.addImageDependency(_image);
+
+            if (container.isEstimatingHeight()) {
+                container.addEstimatedElement(*this, size, this->hasTrailingSpace());
+                return;
+            }
+
             container.addElement(
                 (new ImageLayoutElement(*this, _image, size))->setLink(this->getLink()));
         } else {
-            if (this->textElement != nullptr) {
+            if (this->textElement) {
                 this->textElement->addToContainer(container, MessageElement::Misc);
             }
         }
@@ -122,30 +139,87 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container, MessageElem
 }
 
 // TEXT
-TextElement::TextElement(const QString &text, MessageElement::Flags flags,
+TextElement::TextElement(const QString &_text, MessageElement::Flags flags,
                          const MessageColor &_color, FontStyle _style)
     : MessageElement(flags)
     , color(_color)
     , style(_style)
+    , text(_text)
 {
-    for (QString word : text.split(' ')) {
-        this->words.push_back({word, -1});
+    this->wordOffsets.reserve(_text.count(' ') + 2);
+    this->wordOffsets.push_back(0);
+
+    for (int i = 0; i < _text.length(); i++) {
+        if (_text[i] == ' ') {
+            this->wordOffsets.push_back(i + 1);
+        }
         // fourtf: add logic to store mutliple spaces after message
     }
+
+    this->wordOffsets.push_back(_text.length() + 1);
+}
+
+int TextElement::getWordCount() const
+{
+    return (int)this->wordOffsets.size() - 1;
+}
+
+QStringRef TextElement::getWord(int index) const
+{
+    int start = this->wordOffsets[index];
+
+    return QStringRef(&this->text, start, this->wordOffsets[index + 1] - start - 1);
+}
+
+void TextElement::updateWordWidths(float scale)
+{
+    auto &fontManager = singletons::FontManager::getInstance();
+    int generation = fontManager.getGeneration();
+
+    if (this->widthsGeneration == generation && this->widthsScale == scale) {
+        return;
+    }
+
+    this->widthsGeneration = generation;
+    this->widthsScale = scale;
+
+    int count = this->getWordCount();
+    this->wordWidths.resize(count);
+
+    for (int i = 0; i < count; i++) {
+        this->wordWidths[i] = fontManager.getWordWidth(this->style, scale, this->getWord(i));
+    }
 }
 
 void TextElement::addToContainer(MessageLayoutContainer &container, MessageElement::Flags _flags)
 {
     if (_flags & this->getFlags()) {
-        QFontMetrics &metrics = singletons::FontManager::getInstance().getFontMetrics(
+        QFontMetrics metrics = singletons::FontManager::getInstance().getFontMetrics(
             this->style, container.getScale());
-        singletons::ThemeManager &themeManager =
-            singletons::ThemeManager::ThemeManager::getInstance();
+        // the theme is copied into the key on the gui thread
+        const auto &colors = *container.getLayoutKey().colors;
+
+        // only measures the words again if the font or the scale changed
+        this->updateWordWidths(container.getScale());
+
+        if (container.isEstimatingHeight()) {
+            // words that are wider than a line are not split, it's only an estimate
+            for (int wordWidth : this->wordWidths) {
+                container.addEstimatedElement(*this, QSize(wordWidth, metrics.height()),
+                                              this->hasTrailingSpace());
+            }
+            return;
+        }
 
-        for (Word &word : this->words) {
-            auto getTextLayoutElement = [&](QString text, int width, bool trailingSpace) {
-                QColor color = this->color.getColor(themeManager);
-                themeManager.normalizeColor(color);
+        for (int wordIndex = 0; wordIndex < this->getWordCount(); wordIndex++) {
+            QStringRef word = this->getWord(wordIndex);
+            int wordWidth = this->wordWidths[wordIndex];
+
+            auto getTextLayoutElement = [&](const QStringRef &part, int width, bool trailingSpace) {
+                // the only copy of the word, the layout element keeps it
+                QString text = part.toString();
+                QColor color = this->color.getColor(colors);
+                colors.normalizeColor(color);
 
                 auto e = (new TextLayoutElement(*this, text, QSize(width, metrics.height()), color,
                                                 this->style, container.getScale()))
@@ -154,15 +228,10 @@ void TextElement::addToContainer(MessageLayoutContainer &container, MessageEleme
                 return e;
             };
 
-            // fourtf: add again
-            //            if (word.width == -1) {
-            word.width = metrics.width(word.text);
-            //            }
-
             // see if the text fits in the current line
-            if (container.fitsInLine(word.width)) {
+            if (container.fitsInLine(wordWidth)) {
                 container.addElementNoLineBreak(
-                    getTextLayoutElement(word.text, word.width, this->hasTrailingSpace()));
+                    getTextLayoutElement(word, wordWidth, this->hasTrailingSpace()));
                 continue;
             }
 
@@ -170,44 +239,26 @@ void TextElement::addToContainer(MessageLayoutContainer &container, MessageEleme
             if (!container.atStartOfLine()) {
                 container.breakLine();
 
-                if (container.fitsInLine(word.width)) {
+                if (container.fitsInLine(wordWidth)) {
                     container.addElementNoLineBreak(
-                        getTextLayoutElement(word.text, word.width, this->hasTrailingSpace()));
+                        getTextLayoutElement(word, wordWidth, this->hasTrailingSpace()));
                     continue;
                 }
             }
 
             // we done goofed, we need to wrap the text
-            QString text = word.text;
-            int textLength = text.length();
-            int wordStart = 0;
-            int width = metrics.width(text[0]);
-            int lastWidth = 0;
-
-            for (int i = 1; i < textLength; i++) {
-                int charWidth = metrics.width(text[i]);
-
-                if (!container.fitsInLine(width + charWidth)) {
-                    container.addElementNoLineBreak(getTextLayoutElement(
-                        text.mid(wordStart, i - wordStart), width - lastWidth, false));
-                    container.breakLine();
-
-                    wordStart = i;
-                    lastWidth = width;
-                    width = 0;
-                    if (textLength > i + 2) {
-                        width += metrics.width(text[i]);
-                        width += metrics.width(text[i + 1]);
-                        i += 1;
-                    }
-                    continue;
-                }
-                width += charWidth;
-            }
-
-            container.addElement(getTextLayoutElement(text.mid(wordStart), word.width - lastWidth,
-                                                      this->hasTrailingSpace()));
-            container.breakLine();
+            container.disableRewrap();
+
+            util::wrapWord(word,
+                           [&](const QStringRef &text, int end) {
+                               return container.fitsInLine(metrics.width(rawString(text), end));
+                           },
+                           [&](const QStringRef &part, bool isLastPart) {
+                               container.addElementNoLineBreak(getTextLayoutElement(
+                                   part, metrics.width(rawString(part)),
+                                   isLastPart && this->hasTrailingSpace()));
+                               container.breakLine();
+                           });
         }
     }
 }
@@ -221,38 +272,32 @@ TimestampElement::TimestampElement()
 TimestampElement::TimestampElement(QTime _time)
     : MessageElement(MessageElement::Timestamp)
     , time(_time)
-    , element(formatTime(_time))
 {
-    assert(this->element != nullptr);
-}
-
-TimestampElement::~TimestampElement()
-{
-    delete this->element;
 }
 
 void TimestampElement::addToContainer(MessageLayoutContainer &container,
                                       MessageElement::Flags _flags)
 {
     if (_flags & this->getFlags()) {
-        if (singletons::SettingManager::getInstance().timestampFormat != this->format) {
-            this->format = singletons::SettingManager::getInstance().timestampFormat.getValue();
-            delete this->element;
-            this->element = TimestampElement::formatTime(this->time);
+        // formatted with the first layout, the format of the layout key is read on the gui thread
+        const QString &format = container.getLayoutKey().timestampFormat;
+
+        if (!this->element || format != this->format) {
+            this->format = format;
+            this->formatTime();
         }
 
         this->element->addToContainer(container, _flags);
     }
 }
 
-TextElement *TimestampElement::formatTime(const QTime &time)
+void TimestampElement::formatTime()
 {
     static QLocale locale("en_US");
 
-    QString format =
-        locale.toString(time, singletons::SettingManager::getInstance().timestampFormat);
+    QString text = locale.toString(this->time, this->format);
 
-    return new TextElement(format, Flags::Timestamp, MessageColor::System, FontStyle::Medium);
+    this->element.emplace(text, Flags::Timestamp, MessageColor::System, FontStyle::Medium);
 }
 
 // TWITCH MODERATION
@@ -267,9 +312,16 @@ void TwitchModerationElement::addToContainer(MessageLayoutContainer &container,
     if (_flags & MessageElement::ModeratorTools) {
         QSize size((int)(container.getScale() * 16), (int)(container.getScale() * 16));
 
-        for (const singletons::ModerationAction &m :
-             singletons::SettingManager::getInstance().getModerationActions()) {
-            if (m.isImage()) {
+        const auto &actions = container.getLayoutKey().moderationActions;
+
+        if (!actions) {
+            return;
+        }
+
+        for (const singletons::ModerationAction &m : *actions) {
+            if (container.isEstimatingHeight()) {
+                container.addEstimatedElement(*this, size, true);
+            } else if (m.isImage()) {
                 container.addElement((new ImageLayoutElement(*this, m.getImage(), size))
                                          ->setLink(Link(Link::UserAction, m.getAction())));
             } else {
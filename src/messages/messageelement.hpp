@@ -11,6 +11,7 @@
 #include <QTime>
 
 #include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
 #include "util/emotemap.hpp"
 
 namespace chatterino {
@@ -151,11 +152,20 @@ class TextElement : public MessageElement
     MessageColor color;
     FontStyle style;
 
-    struct Word {
-        QString text;
-        int width = -1;
-    };
-    std::vector<Word> words;
+    // the words are stored as offsets into the text, word i spans from wordOffsets[i] to
+    // wordOffsets[i + 1] - 1 (the space in between is not part of the word)
+    QString text;
+    std::vector<int> wordOffsets;
+
+    // widths of the words for the font generation and scale they were measured with
+    std::vector<int> wordWidths;
+    int widthsGeneration = -1;
+    float widthsScale = 0;
+
+    int getWordCount() const;
+    // points into the text, the words are only copied for the layout elements
+    QStringRef getWord(int index) const;
+    void updateWordWidths(float scale);
 
 public:
     TextElement(const QString &text, MessageElement::Flags flags,
@@ -172,11 +182,10 @@ public:
 class EmoteElement : public MessageElement
 {
     const util::EmoteData data;
-    TextElement *textElement;
+    boost::optional<TextElement> textElement;
 
 public:
     EmoteElement(const util::EmoteData &data, MessageElement::Flags flags);
-    ~EmoteElement();
 
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElement::Flags flags) override;
@@ -186,18 +195,19 @@ public:
 class TimestampElement : public MessageElement
 {
     QTime time;
-    TextElement *element;
+    boost::optional<TextElement> element;
     QString format;
 
 public:
     TimestampElement();
     TimestampElement(QTime time);
-    virtual ~TimestampElement();
 
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElement::Flags flags) override;
 
-    TextElement *formatTime(const QTime &time);
+private:
+    // (re)creates the text element in place with the format
+    void formatTime();
 };
 
 // adds all the custom moderation buttons, adds a variable amount of items depending on settings
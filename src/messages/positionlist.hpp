@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+// Sorted positions of the messages in a LimitedQueue, used by the indexes of a channel.
+// Positions are usually added at the end and removed at the start, so positions removed at the
+// start are only skipped and cut off once they make up half of the vector.
+class PositionList
+{
+public:
+    void insert(size_t position)
+    {
+        // new messages are added at the end, so this is usually the last element
+        this->positions.insert(std::upper_bound(this->begin(), this->end(), position), position);
+    }
+
+    void remove(size_t position)
+    {
+        if (this->empty()) {
+            return;
+        }
+
+        // messages are usually removed at the start
+        if (*this->begin() == position) {
+            this->start++;
+        } else {
+            auto it = std::lower_bound(this->begin(), this->end(), position);
+
+            if (it == this->end() || *it != position) {
+                return;
+            }
+
+            this->positions.erase(it);
+        }
+
+        if (this->start * 2 >= this->positions.size()) {
+            this->positions.erase(this->positions.begin(), this->begin());
+            this->start = 0;
+
+            if (this->positions.size() * 4 < this->positions.capacity()) {
+                this->positions.shrink_to_fit();
+            }
+        }
+    }
+
+    bool empty() const
+    {
+        return this->start == this->positions.size();
+    }
+
+    size_t size() const
+    {
+        return this->positions.size() - this->start;
+    }
+
+    std::vector<size_t>::const_iterator begin() const
+    {
+        return this->positions.begin() + this->start;
+    }
+
+    std::vector<size_t>::const_iterator end() const
+    {
+        return this->positions.end();
+    }
+
+    // bytes allocated for the positions
+    size_t getMemoryUsage() const
+    {
+        return this->positions.capacity() * sizeof(size_t);
+    }
+
+private:
+    std::vector<size_t> positions;
+    size_t start = 0;
+};
+
+}  // namespace messages
+}  // namespace chatterino
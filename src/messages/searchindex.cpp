@@ -0,0 +1,190 @@
+#include "messages/searchindex.hpp"
+#include "messages/message.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+namespace messages {
+
+namespace {
+
+// rough size of a node of the map and the header of the word's string data
+const size_t ENTRY_OVERHEAD = 96;
+
+}  // namespace
+
+bool SearchQuery::isEmpty() const
+{
+    return this->prefixes.isEmpty() && this->phrases.isEmpty() && this->users.isEmpty();
+}
+
+SearchQuery SearchQuery::parse(const QString &text)
+{
+    SearchQuery query;
+
+    // phrases
+    QStringList parts = text.split('"');
+
+    for (int i = 0; i < parts.size(); i++) {
+        // every second part is inside of quotes
+        if (i % 2 == 1) {
+            QString phrase = parts[i].trimmed().toCaseFolded();
+
+            if (!phrase.isEmpty()) {
+                query.phrases.append(phrase);
+            }
+            continue;
+        }
+
+        for (const QString &part : parts[i].split(' ', QString::SkipEmptyParts)) {
+            if (part.startsWith("from:", Qt::CaseInsensitive)) {
+                QString user = part.mid(5).toLower();
+
+                if (user.startsWith('@')) {
+                    user = user.mid(1);
+                }
+
+                if (!user.isEmpty()) {
+                    query.users.append(user);
+                }
+                continue;
+            }
+
+            query.prefixes.append(SearchIndex::getWords(part));
+        }
+    }
+
+    return query;
+}
+
+void SearchIndex::addMessage(const Message &message, size_t position)
+{
+    QStringList words = SearchIndex::getWords(message.getSearchText());
+    words.removeDuplicates();
+
+    for (const QString &word : words) {
+        auto it = this->positionsByWord.find(word);
+
+        if (it == this->positionsByWord.end()) {
+            it = this->positionsByWord.emplace(word, PositionList()).first;
+            this->memoryUsage += SearchIndex::getEntrySize(word);
+        }
+
+        PositionList &positions = it->second;
+
+        this->memoryUsage -= positions.getMemoryUsage();
+        positions.insert(position);
+        this->memoryUsage += positions.getMemoryUsage();
+    }
+}
+
+void SearchIndex::removeMessage(const Message &message, size_t position)
+{
+    QStringList words = SearchIndex::getWords(message.getSearchText());
+    words.removeDuplicates();
+
+    for (const QString &word : words) {
+        auto it = this->positionsByWord.find(word);
+        if (it == this->positionsByWord.end()) {
+            continue;
+        }
+
+        PositionList &positions = it->second;
+
+        this->memoryUsage -= positions.getMemoryUsage();
+        positions.remove(position);
+
+        if (positions.empty()) {
+            this->memoryUsage -= SearchIndex::getEntrySize(word);
+            this->positionsByWord.erase(it);
+        } else {
+            this->memoryUsage += positions.getMemoryUsage();
+        }
+    }
+}
+
+std::vector<size_t> SearchIndex::findPrefix(const QString &prefix) const
+{
+    std::vector<size_t> positions;
+    size_t wordCount = 0;
+
+    // the words starting with prefix are next to each other in the map
+    for (auto it = this->positionsByWord.lower_bound(prefix);
+         it != this->positionsByWord.end() && it->first.startsWith(prefix); ++it) {
+        positions.insert(positions.end(), it->second.begin(), it->second.end());
+        wordCount++;
+    }
+
+    // the positions of a single word are already sorted
+    if (wordCount > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    return positions;
+}
+
+std::vector<size_t> SearchIndex::findWord(const QString &word) const
+{
+    auto it = this->positionsByWord.find(word);
+
+    if (it == this->positionsByWord.end()) {
+        return std::vector<size_t>();
+    }
+
+    return std::vector<size_t>(it->second.begin(), it->second.end());
+}
+
+size_t SearchIndex::getMemoryUsage() const
+{
+    return this->memoryUsage;
+}
+
+size_t SearchIndex::getEntrySize(const QString &word)
+{
+    return ENTRY_OVERHEAD + (size_t)word.size() * sizeof(QChar);
+}
+
+QStringList SearchIndex::getWords(const QString &text)
+{
+    QStringList words;
+    QString folded = text.toCaseFolded();
+
+    int start = -1;
+
+    for (int i = 0; i <= folded.length(); i++) {
+        bool isWordChar = i < folded.length() && (folded[i].isLetterOrNumber() || folded[i] == '_');
+
+        if (isWordChar && start == -1) {
+            start = i;
+        } else if (!isWordChar && start != -1) {
+            words.append(folded.mid(start, i - start));
+            start = -1;
+        }
+    }
+
+    return words;
+}
+
+void intersectPositions(std::vector<size_t> &positions, const std::vector<size_t> &other)
+{
+    size_t count = 0;
+    auto otherIt = other.begin();
+
+    for (size_t position : positions) {
+        otherIt = std::lower_bound(otherIt, other.end(), position);
+
+        if (otherIt == other.end()) {
+            break;
+        }
+
+        if (*otherIt == position) {
+            positions[count++] = position;
+        }
+    }
+
+    positions.resize(count);
+}
+
+}  // namespace messages
+}  // namespace chatterino
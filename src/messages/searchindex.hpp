@@ -0,0 +1,60 @@
+#pragma once
+
+#include "messages/positionlist.hpp"
+
+#include <QString>
+#include <QStringList>
+
+#include <map>
+#include <vector>
+
+namespace chatterino {
+namespace messages {
+
+struct Message;
+
+// A parsed search query, all parts have to match
+// - hello      messages containing a word that starts with "hello"
+// - "a phrase" messages containing the exact phrase
+// - from:name  messages sent by the user, multiple users are combined with "or"
+struct SearchQuery {
+    QStringList prefixes;
+    QStringList phrases;
+    QStringList users;
+
+    bool isEmpty() const;
+
+    static SearchQuery parse(const QString &text);
+};
+
+// Inverted index from case folded words to the positions of the messages that contain them.
+// The positions are the absolute positions of the LimitedQueue the messages are stored in, they
+// are kept sorted so they can be intersected quickly.
+class SearchIndex
+{
+public:
+    void addMessage(const Message &message, size_t position);
+    void removeMessage(const Message &message, size_t position);
+
+    // sorted positions of the messages that contain a word starting with prefix
+    std::vector<size_t> findPrefix(const QString &prefix) const;
+    // sorted positions of the messages that contain the word
+    std::vector<size_t> findWord(const QString &word) const;
+    // estimated memory used by the words and positions
+    size_t getMemoryUsage() const;
+
+    // splits the text into case folded words
+    static QStringList getWords(const QString &text);
+
+private:
+    std::map<QString, PositionList> positionsByWord;
+    size_t memoryUsage = 0;
+
+    static size_t getEntrySize(const QString &word);
+};
+
+// keeps the positions that are in both sorted vectors
+void intersectPositions(std::vector<size_t> &positions, const std::vector<size_t> &other);
+
+}  // namespace messages
+}  // namespace chatterino
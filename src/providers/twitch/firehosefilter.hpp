@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+namespace chatterino {
+namespace providers {
+namespace twitch {
+
+// Decides which messages of a fast channel are shown. Once a channel gets more messages per
+// second than the limit, only highlights and every nth message are shown until the rate drops
+// below three quarters of the limit again.
+class FirehoseFilter
+{
+public:
+    // counts the message, returns true if it should be shown. a limit of 0 shows all messages
+    bool addMessage(std::chrono::steady_clock::time_point time, int limit, bool highlighted)
+    {
+        // count the messages of the last second
+        this->recentMessageTimes.push_back(time);
+
+        while (time - this->recentMessageTimes.front() > std::chrono::seconds(1)) {
+            this->recentMessageTimes.pop_front();
+        }
+
+        int rate = this->getRate();
+
+        // the mode ends at a lower rate so it doesn't flicker around the limit. with small limits
+        // three quarters round down to 0, which would never end it
+        bool active = limit > 0 && rate > (this->active ? getExitRate(limit) : limit);
+
+        if (active != this->active) {
+            this->active = active;
+            this->sampleCounter = 0;
+        }
+
+        if (!this->active || highlighted) {
+            return true;
+        }
+
+        // show every nth message, about as many messages as the limit allows are shown then
+        int interval = std::max(1, (rate + limit - 1) / limit);
+
+        if (++this->sampleCounter >= interval) {
+            this->sampleCounter = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    // whether the limit was exceeded and only some messages are shown
+    bool isActive() const
+    {
+        return this->active;
+    }
+
+    // messages within the last second
+    int getRate() const
+    {
+        return (int)this->recentMessageTimes.size();
+    }
+
+    // the mode ends once the rate isn't higher than this anymore
+    static int getExitRate(int limit)
+    {
+        return std::max(1, limit * 3 / 4);
+    }
+
+private:
+    std::deque<std::chrono::steady_clock::time_point> recentMessageTimes;
+    bool active = false;
+    int sampleCounter = 0;
+};
+
+}  // namespace twitch
+}  // namespace providers
+}  // namespace chatterino
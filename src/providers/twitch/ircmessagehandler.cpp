@@ -65,7 +65,7 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
     QString chanName = message->parameter(0);
 
     // check channel name length
-    if (chanName.length() >= 2)
+    if (chanName.length() < 2)
         return;
 
     chanName = chanName.mid(1);
@@ -81,7 +81,9 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
 
     // check if the chat has been cleared by a moderator
     if (message->parameters().length() == 1) {
-        chan->addMessage(Message::createSystemMessage("Chat has been cleared by a moderator."));
+        TwitchServer::getInstance().runAfterPendingMessages(chan, [chan] {
+            chan->addMessage(Message::createSystemMessage("Chat has been cleared by a moderator."));
+        });
 
         return;
     }
@@ -101,13 +103,22 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
         reason = v.toString();
     }
 
+    // the messages of the user that are still being built have to be disabled as well
+    TwitchServer::getInstance().runAfterPendingMessages(chan, [=] {
+        this->timeoutUser(chan, username, durationInSeconds, reason);  //
+    });
+}
+
+void IrcMessageHandler::timeoutUser(std::shared_ptr<Channel> chan, const QString &username,
+                                    const QString &durationInSeconds, const QString &reason)
+{
     // add the notice that the user has been timed out
     LimitedQueueSnapshot<MessagePtr> snapshot = chan->getMessageSnapshot();
     bool addMessage = true;
     int snapshotLength = snapshot.getLength();
 
     for (int i = std::max(0, snapshotLength - 20); i < snapshotLength; i++) {
-        if (snapshot[i]->flags & Message::Timeout && snapshot[i]->loginName == username) {
+        if (snapshot[i]->flags & Message::Timeout && snapshot[i]->timeoutUser == username) {
             MessagePtr replacement(
                 Message::createTimeoutMessage(username, durationInSeconds, reason, true));
             chan->replaceMessage(snapshot[i], replacement);
@@ -121,10 +132,8 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
     }
 
     // disable the messages from the user
-    for (int i = 0; i < snapshotLength; i++) {
-        if (!(snapshot[i]->flags & Message::Timeout) && snapshot[i]->loginName == username) {
-            snapshot[i]->flags &= Message::Disabled;
-        }
+    for (const MessagePtr &userMessage : chan->getMessagesFromUser(username)) {
+        userMessage->flags |= Message::Disabled;
     }
 
     // refresh all
@@ -157,9 +166,12 @@ void IrcMessageHandler::handleWhisperMessage(Communi::IrcMessage *message)
     auto c = TwitchServer::getInstance().whispersChannel.get();
 
     twitch::TwitchMessageBuilder builder(c, message, message->parameter(1), args);
+    builder.snapshot = twitch::TwitchMessageBuilder::Snapshot::take(c);
 
     if (!builder.isIgnored()) {
         messages::MessagePtr _message = builder.build();
+        builder.finishOnGuiThread();
+
         if (_message->flags & messages::Message::Highlighted) {
             TwitchServer::getInstance().mentionsChannel->addMessage(_message);
         }
@@ -200,7 +212,9 @@ void IrcMessageHandler::handleNoticeMessage(Communi::IrcNoticeMessage *message)
     if (broadcast) {
         // fourtf: send to all twitch channels
         TwitchServer::getInstance().forEachChannelAndSpecialChannels([msg](const auto &c) {
-            c->addMessage(msg);  //
+            TwitchServer::getInstance().runAfterPendingMessages(c, [c, msg] {
+                c->addMessage(msg);  //
+            });
         });
 
         return;
@@ -216,7 +230,9 @@ void IrcMessageHandler::handleNoticeMessage(Communi::IrcNoticeMessage *message)
         return;
     }
 
-    channel->addMessage(msg);
+    TwitchServer::getInstance().runAfterPendingMessages(channel, [channel, msg] {
+        channel->addMessage(msg);  //
+    });
 }
 
 void IrcMessageHandler::handleWriteConnectionNoticeMessage(Communi::IrcNoticeMessage *message)
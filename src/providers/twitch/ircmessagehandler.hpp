@@ -2,7 +2,11 @@
 
 #include <IrcMessage>
 
+#include <memory>
+
 namespace chatterino {
+class Channel;
+
 namespace singletons {
 class ChannelManager;
 class ResourceManager;
@@ -27,6 +31,10 @@ public:
     void handleModeMessage(Communi::IrcMessage *message);
     void handleNoticeMessage(Communi::IrcNoticeMessage *message);
     void handleWriteConnectionNoticeMessage(Communi::IrcNoticeMessage *message);
+
+private:
+    void timeoutUser(std::shared_ptr<Channel> chan, const QString &username,
+                     const QString &durationInSeconds, const QString &reason);
 };
 }  // namespace twitch
 }  // namespace providers
@@ -6,6 +6,7 @@
 #include "singletons/channelmanager.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/ircmanager.hpp"
+#include "singletons/loggingmanager.hpp"
 #include "singletons/settingsmanager.hpp"
 #include "util/urlfetch.hpp"
 
@@ -13,6 +14,8 @@
 #include <QThread>
 #include <QTimer>
 
+#include <algorithm>
+
 namespace chatterino {
 namespace providers {
 namespace twitch {
@@ -30,6 +33,8 @@ TwitchChannel::TwitchChannel(const QString &channelName, Communi::IrcConnection
 {
     debug::Log("[TwitchChannel:{}] Opened", this->name);
 
+    this->useScrollbackBudget();
+
     this->reloadChannelEmotes();
 
     this->liveStatusTimer = new QTimer;
@@ -69,6 +74,13 @@ TwitchChannel::TwitchChannel(const QString &channelName, Communi::IrcConnection
     this->chattersListTimer = new QTimer;
     QObject::connect(this->chattersListTimer, &QTimer::timeout, doRefreshChatters);
     this->chattersListTimer->start(5 * 60 * 1000);
+
+    this->firehoseTimer = new QTimer;
+    this->firehoseTimer->setSingleShot(true);
+    QObject::connect(this->firehoseTimer, &QTimer::timeout, [this]() {
+        this->firehoseChanged();  //
+    });
+    this->firehoseTimer->setInterval(1000);
 }
 
 TwitchChannel::~TwitchChannel()
@@ -80,6 +92,9 @@ TwitchChannel::~TwitchChannel()
 
     this->chattersListTimer->stop();
     this->chattersListTimer->deleteLater();
+
+    this->firehoseTimer->stop();
+    this->firehoseTimer->deleteLater();
 }
 
 bool TwitchChannel::isEmpty() const
@@ -92,6 +107,55 @@ bool TwitchChannel::canSendMessage() const
     return !this->isEmpty();
 }
 
+void TwitchChannel::addChatMessage(messages::MessagePtr message)
+{
+    if (this->updateFirehoseMode(message)) {
+        this->addMessage(message);
+        return;
+    }
+
+    // skipped messages are still logged and used for completions
+    if (!message->loginName.isEmpty()) {
+        this->addRecentChatter(message);
+    }
+
+    singletons::LoggingManager::getInstance().addMessage(this->name, message);
+
+    this->skippedMessageCount++;
+
+    if (!this->firehoseTimer->isActive()) {
+        this->firehoseTimer->start();
+    }
+}
+
+bool TwitchChannel::isFirehoseMode() const
+{
+    return this->firehoseFilter.isActive();
+}
+
+int TwitchChannel::getSkippedMessageCount() const
+{
+    return this->skippedMessageCount;
+}
+
+bool TwitchChannel::updateFirehoseMode(const messages::MessagePtr &message)
+{
+    int limit = singletons::SettingManager::getInstance().firehoseMessageRate.getValue();
+    bool highlighted = message->flags & messages::Message::Highlighted;
+    bool wasFirehoseMode = this->firehoseFilter.isActive();
+
+    bool show =
+        this->firehoseFilter.addMessage(std::chrono::steady_clock::now(), limit, highlighted);
+
+    if (this->firehoseFilter.isActive() != wasFirehoseMode) {
+        this->skippedMessageCount = 0;
+
+        this->firehoseChanged();
+    }
+
+    return show;
+}
+
 void TwitchChannel::setRoomID(const QString &_roomID)
 {
     this->roomID = _roomID;
@@ -260,6 +324,7 @@ void TwitchChannel::fetchRecentMessages()
         auto msgArray = obj.value("messages").toArray();
         if (msgArray.size() > 0) {
             std::vector<messages::MessagePtr> messages;
+            auto snapshot = twitch::TwitchMessageBuilder::Snapshot::take(channel);
 
             for (int i = 0; i < msgArray.size(); i++) {
                 QByteArray content = msgArray[i].toString().toUtf8();
@@ -268,8 +333,10 @@ void TwitchChannel::fetchRecentMessages()
 
                 messages::MessageParseArgs args;
                 twitch::TwitchMessageBuilder builder(channel, privMsg, args);
+                builder.snapshot = snapshot;
                 if (!builder.isIgnored()) {
                     messages.push_back(builder.build());
+                    builder.finishOnGuiThread();
                 }
             }
             channel->addMessagesAtStart(messages);
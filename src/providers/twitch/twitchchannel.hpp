@@ -4,6 +4,7 @@
 
 #include "channel.hpp"
 #include "common.hpp"
+#include "providers/twitch/firehosefilter.hpp"
 #include "singletons/emotemanager.hpp"
 #include "singletons/ircmanager.hpp"
 #include "util/concurrentmap.hpp"
@@ -47,6 +48,16 @@ public:
     pajlada::Signals::NoArgBoltSignal fetchMessages;
     boost::signals2::signal<void()> userStateChanged;
 
+    // Firehose mode
+    // once the channel gets more messages per second than the setting allows, only highlights
+    // and a sample of the chat messages are shown. the others are only logged. mod actions aren't
+    // chat messages and are always shown.
+    void addChatMessage(messages::MessagePtr message);
+    bool isFirehoseMode() const;
+    int getSkippedMessageCount() const;
+    // the mode or the count of skipped messages changed, at most once per second for the count
+    boost::signals2::signal<void()> firehoseChanged;
+
     QString roomID;
     bool isLive;
     QString streamViewerCount;
@@ -62,6 +73,9 @@ private:
 
     void fetchRecentMessages();
 
+    // returns true if the message should be shown
+    bool updateFirehoseMode(const messages::MessagePtr &message);
+
     boost::signals2::connection connectedConnection;
 
     bool mod;
@@ -70,6 +84,10 @@ private:
 
     Communi::IrcConnection *readConnecetion;
 
+    FirehoseFilter firehoseFilter;
+    int skippedMessageCount = 0;
+    QTimer *firehoseTimer;
+
     friend class TwitchServer;
 };
 
@@ -8,6 +8,7 @@
 #include "singletons/settingsmanager.hpp"
 #include "singletons/thememanager.hpp"
 #include "singletons/windowmanager.hpp"
+#include "util/stringinterner.hpp"
 
 #include <QApplication>
 #include <QDebug>
@@ -26,8 +27,8 @@ TwitchMessageBuilder::TwitchMessageBuilder(Channel *_channel,
     , twitchChannel(dynamic_cast<TwitchChannel *>(_channel))
     , ircMessage(_ircMessage)
     , args(_args)
-    , tags(this->ircMessage->tags())
-    , usernameColor(singletons::ThemeManager::getInstance().messages.textColors.system)
+    , rawLine(_ircMessage->toData())
+    , tags(this->rawLine)
     , originalMessage(_ircMessage->content())
     , action(_ircMessage->isAction())
 {
@@ -40,12 +41,35 @@ TwitchMessageBuilder::TwitchMessageBuilder(Channel *_channel,
     , twitchChannel(dynamic_cast<TwitchChannel *>(_channel))
     , ircMessage(_ircMessage)
     , args(_args)
-    , tags(this->ircMessage->tags())
-    , usernameColor(singletons::ThemeManager::getInstance().messages.textColors.system)
+    , rawLine(_ircMessage->toData())
+    , tags(this->rawLine)
     , originalMessage(content)
 {
 }
 
+TwitchMessageBuilder::Snapshot TwitchMessageBuilder::Snapshot::take(Channel *channel)
+{
+    singletons::ResourceManager &resourceManager = singletons::ResourceManager::getInstance();
+    auto currentUser = singletons::AccountManager::getInstance().Twitch.getCurrent();
+
+    Snapshot snapshot;
+
+    auto twitchChannel = dynamic_cast<TwitchChannel *>(channel);
+
+    if (twitchChannel != nullptr) {
+        snapshot.channelResources = resourceManager.getChannel(twitchChannel->roomID);
+    }
+
+    snapshot.badgeSets = resourceManager.badgeSets;
+    snapshot.chatterinoBadges = resourceManager.chatterinoBadges;
+
+    snapshot.systemColor = singletons::ThemeManager::getInstance().messages.textColors.system;
+    snapshot.currentUserName = currentUser->getUserName();
+    snapshot.currentUserColor = currentUser->color;
+
+    return snapshot;
+}
+
 bool TwitchMessageBuilder::isIgnored() const
 {
     singletons::SettingManager &settings = singletons::SettingManager::getInstance();
@@ -83,7 +107,7 @@ MessagePtr TwitchMessageBuilder::build()
     bool isPastMsg = this->tags.contains("historical");
     if (isPastMsg) {
         // This may be architecture dependent(datatype)
-        qint64 ts = this->tags.value("tmi-sent-ts").toLongLong();
+        qint64 ts = this->tags.get("tmi-sent-ts").toNumber();
         QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(ts);
         this->emplace<TimestampElement>(dateTime.time());
     } else {
@@ -104,20 +128,18 @@ MessagePtr TwitchMessageBuilder::build()
     }
 
     QString bits;
-    auto iterator = this->tags.find("bits");
-    if (iterator != this->tags.end()) {
-        bits = iterator.value().toString();
+    TagRef bitsTag = this->tags.get("bits");
+    if (!bitsTag.isNull()) {
+        bits = bitsTag.toString();
     }
 
     // twitch emotes
     std::vector<std::pair<long, util::EmoteData>> twitchEmotes;
 
-    iterator = this->tags.find("emotes");
-    if (iterator != this->tags.end()) {
-        QStringList emoteString = iterator.value().toString().split('/');
-
-        for (QString emote : emoteString) {
-            this->appendTwitchEmote(ircMessage, emote, twitchEmotes);
+    TagRef emotesTag = this->tags.get("emotes");
+    if (!emotesTag.isNull()) {
+        for (const TwitchEmoteOccurence &emote : parseTwitchEmotes(emotesTag)) {
+            this->appendTwitchEmote(emote, twitchEmotes);
         }
 
         struct {
@@ -211,17 +233,18 @@ MessagePtr TwitchMessageBuilder::build()
         i++;
     }
 
-    this->message->searchText = this->userName + ": " + this->originalMessage;
+    // shares its data with the message of the irc message
+    this->message->messageText = this->originalMessage;
 
     return this->getMessage();
 }
 
 void TwitchMessageBuilder::parseMessageID()
 {
-    auto iterator = this->tags.find("id");
+    TagRef id = this->tags.get("id");
 
-    if (iterator != this->tags.end()) {
-        this->messageID = iterator.value().toString();
+    if (!id.isNull()) {
+        this->messageID = id.toString();
     }
 }
 
@@ -231,14 +254,10 @@ void TwitchMessageBuilder::parseRoomID()
         return;
     }
 
-    auto iterator = this->tags.find("room-id");
+    TagRef roomID = this->tags.get("room-id");
 
-    if (iterator != std::end(this->tags)) {
-        this->roomID = iterator.value().toString();
-
-        if (this->twitchChannel->roomID.isEmpty()) {
-            this->twitchChannel->roomID = this->roomID;
-        }
+    if (!roomID.isNull()) {
+        this->roomID = roomID.toString();
     }
 }
 
@@ -253,18 +272,21 @@ void TwitchMessageBuilder::appendChannelName()
 
 void TwitchMessageBuilder::parseUsername()
 {
-    auto iterator = this->tags.find("color");
-    if (iterator != this->tags.end()) {
-        this->usernameColor = QColor(iterator.value().toString());
+    TagRef color = this->tags.get("color");
+    if (!color.isNull()) {
+        this->usernameColor = QColor(color.toString());
+    } else {
+        this->usernameColor = this->snapshot.systemColor;
     }
 
     // username
     this->userName = this->ircMessage->nick();
 
     if (this->userName.isEmpty()) {
-        this->userName = this->tags.value(QLatin1String("login")).toString();
+        this->userName = this->tags.get("login").toString();
     }
 
+    this->userName = util::StringInterner::getInstance().intern(this->userName);
     this->message->loginName = this->userName;
 }
 
@@ -274,9 +296,9 @@ void TwitchMessageBuilder::appendUsername()
     this->message->loginName = username;
     QString localizedName;
 
-    auto iterator = this->tags.find("display-name");
-    if (iterator != this->tags.end()) {
-        QString displayName = iterator.value().toString();
+    TagRef displayNameTag = this->tags.get("display-name");
+    if (!displayNameTag.isNull()) {
+        QString displayName = util::StringInterner::getInstance().intern(displayNameTag.toString());
 
         if (QString::compare(displayName, this->userName, Qt::CaseInsensitive) == 0) {
             username = displayName;
@@ -330,20 +352,17 @@ void TwitchMessageBuilder::appendUsername()
                                    FontStyle::MediumBold)
             ->setLink({Link::UserInfo, this->userName});
 
-        auto currentUser = singletons::AccountManager::getInstance().Twitch.getCurrent();
-
         // Separator
-        this->emplace<TextElement>(
-            "->", MessageElement::Text,
-            singletons::ThemeManager::getInstance().messages.textColors.system, FontStyle::Medium);
+        this->emplace<TextElement>("->", MessageElement::Text, this->snapshot.systemColor,
+                                   FontStyle::Medium);
 
-        QColor selfColor = currentUser->color;
+        QColor selfColor = this->snapshot.currentUserColor;
         if (!selfColor.isValid()) {
-            selfColor = singletons::ThemeManager::getInstance().messages.textColors.system;
+            selfColor = this->snapshot.systemColor;
         }
 
         // Your own username
-        this->emplace<TextElement>(currentUser->getUserName() + ":", MessageElement::Text,
+        this->emplace<TextElement>(this->snapshot.currentUserName + ":", MessageElement::Text,
                                    selfColor, FontStyle::MediumBold);
     } else {
         if (!this->action) {
@@ -358,131 +377,90 @@ void TwitchMessageBuilder::appendUsername()
 
 void TwitchMessageBuilder::parseHighlights()
 {
-    static auto player = new QMediaPlayer;
-    static QUrl currentPlayerUrl;
     singletons::SettingManager &settings = singletons::SettingManager::getInstance();
-    auto currentUser = singletons::AccountManager::getInstance().Twitch.getCurrent();
-
-    QString currentUsername = currentUser->getUserName();
 
-    if (this->ircMessage->nick() == currentUsername) {
-        currentUser->color = this->usernameColor;
+    if (this->ircMessage->nick() == this->snapshot.currentUserName) {
         // Do nothing. Highlights cannot be triggered by yourself
         return;
     }
 
-    // update the media player url if necessary
-    QUrl highlightSoundUrl;
-    if (settings.customHighlightSound) {
-        highlightSoundUrl = QUrl(settings.pathHighlightSound.getValue());
-    } else {
-        highlightSoundUrl = QUrl("qrc:/sounds/ping2.wav");
-    }
+    // rebuilt by the settings when the highlights or the current user change
+    auto matcher = settings.getHighlightMatcher();
 
-    if (currentPlayerUrl != highlightSoundUrl) {
-        player->setMedia(highlightSoundUrl);
+    if (!matcher->isBlacklisted(this->ircMessage->nick())) {
+        messages::HighlightMatcher::Result result = matcher->match(this->originalMessage);
 
-        currentPlayerUrl = highlightSoundUrl;
-    }
+        if (result.highlight) {
+            debug::Log("Highlight because {} contains {}", this->originalMessage, result.key);
+        }
 
-    QStringList blackList =
-        settings.highlightUserBlacklist.getValue().split("\n", QString::SkipEmptyParts);
+        this->setHighlight(result.highlight);
 
-    // TODO: This vector should only be rebuilt upon highlights being changed
-    auto activeHighlights = settings.highlightProperties.getValue();
+        this->highlightSound = result.sound;
+        this->highlightAlert = result.alert;
 
-    if (settings.enableHighlightsSelf && currentUsername.size() > 0) {
-        messages::HighlightPhrase selfHighlight;
-        selfHighlight.key = currentUsername;
-        selfHighlight.sound = settings.enableHighlightSound;
-        selfHighlight.alert = settings.enableHighlightTaskbar;
-        activeHighlights.emplace_back(std::move(selfHighlight));
+        if (result.highlight) {
+            this->message->flags &= Message::Highlighted;
+        }
     }
+}
 
-    bool doHighlight = false;
-    bool playSound = false;
-    bool doAlert = false;
+void TwitchMessageBuilder::finishOnGuiThread()
+{
+    if (this->twitchChannel != nullptr && !this->roomID.isEmpty() &&
+        this->twitchChannel->roomID.isEmpty()) {
+        this->twitchChannel->roomID = this->roomID;
+    }
 
-    bool hasFocus = (QApplication::focusWidget() != nullptr);
+    auto currentUser = singletons::AccountManager::getInstance().Twitch.getCurrent();
 
-    if (!blackList.contains(this->ircMessage->nick(), Qt::CaseInsensitive)) {
-        for (const messages::HighlightPhrase &highlight : activeHighlights) {
-            if (this->originalMessage.contains(highlight.key, Qt::CaseInsensitive)) {
-                debug::Log("Highlight because {} contains {}", this->originalMessage,
-                           highlight.key);
-                doHighlight = true;
+    if (this->ircMessage->nick() == currentUser->getUserName()) {
+        currentUser->color = this->usernameColor;
+    }
 
-                if (highlight.sound) {
-                    playSound = true;
-                }
+    static auto player = new QMediaPlayer;
+    static QUrl currentPlayerUrl;
+    singletons::SettingManager &settings = singletons::SettingManager::getInstance();
 
-                if (highlight.alert) {
-                    doAlert = true;
-                }
+    bool hasFocus = (QApplication::focusWidget() != nullptr);
 
-                if (playSound && doAlert) {
-                    // Break if no further action can be taken from other highlights
-                    // This might change if highlights can have custom colors/sounds/actions
-                    break;
-                }
-            }
+    if (this->highlightSound && (!hasFocus || settings.highlightAlwaysPlaySound)) {
+        // update the media player url if necessary
+        QUrl highlightSoundUrl;
+        if (settings.customHighlightSound) {
+            highlightSoundUrl = QUrl(settings.pathHighlightSound.getValue());
+        } else {
+            highlightSoundUrl = QUrl("qrc:/sounds/ping2.wav");
         }
 
-        this->setHighlight(doHighlight);
+        if (currentPlayerUrl != highlightSoundUrl) {
+            player->setMedia(highlightSoundUrl);
 
-        if (playSound && (!hasFocus || settings.highlightAlwaysPlaySound)) {
-            player->play();
+            currentPlayerUrl = highlightSoundUrl;
         }
 
-        if (doAlert) {
-            QApplication::alert(singletons::WindowManager::getInstance().getMainWindow().window(),
-                                2500);
-        }
+        player->play();
+    }
 
-        if (doHighlight) {
-            this->message->flags &= Message::Highlighted;
-        }
+    if (this->highlightAlert) {
+        QApplication::alert(singletons::WindowManager::getInstance().getMainWindow().window(),
+                            2500);
     }
 }
 
-void TwitchMessageBuilder::appendTwitchEmote(const Communi::IrcMessage *ircMessage,
-                                             const QString &emote,
+void TwitchMessageBuilder::appendTwitchEmote(const TwitchEmoteOccurence &emote,
                                              std::vector<std::pair<long int, util::EmoteData>> &vec)
 {
     singletons::EmoteManager &emoteManager = singletons::EmoteManager::getInstance();
-    if (!emote.contains(':')) {
-        return;
-    }
 
-    QStringList parameters = emote.split(':');
-
-    if (parameters.length() < 2) {
+    if (emote.start >= emote.end || emote.end > this->originalMessage.length()) {
         return;
     }
 
-    long int id = std::stol(parameters.at(0).toStdString(), nullptr, 10);
-
-    QStringList occurences = parameters.at(1).split(',');
-
-    for (QString occurence : occurences) {
-        QStringList coords = occurence.split('-');
-
-        if (coords.length() < 2) {
-            return;
-        }
-
-        long int start = std::stol(coords.at(0).toStdString(), nullptr, 10);
-        long int end = std::stol(coords.at(1).toStdString(), nullptr, 10);
-
-        if (start >= end || start < 0 || end > this->originalMessage.length()) {
-            return;
-        }
-
-        QString name = this->originalMessage.mid(start, end - start + 1);
+    QString name = this->originalMessage.mid(emote.start, emote.end - emote.start + 1);
 
-        vec.push_back(
-            std::pair<long int, util::EmoteData>(start, emoteManager.getTwitchEmoteById(id, name)));
-    }
+    vec.push_back(std::pair<long int, util::EmoteData>(
+        emote.start, emoteManager.getTwitchEmoteById((long int)emote.id, name)));
 }
 
 bool TwitchMessageBuilder::tryAppendEmote(QString &emoteString)
@@ -522,24 +500,25 @@ bool TwitchMessageBuilder::tryAppendEmote(QString &emoteString)
 void TwitchMessageBuilder::appendTwitchBadges()
 {
     singletons::ResourceManager &resourceManager = singletons::ResourceManager::getInstance();
-    const auto &channelResources = resourceManager.channels[this->roomID];
+    const auto &channelResources = this->snapshot.channelResources;
 
-    auto iterator = this->tags.find("badges");
+    TagRef badges = this->tags.get("badges");
 
-    if (iterator == this->tags.end()) {
+    if (badges.isNull()) {
         // No badges in this message
         return;
     }
 
-    QStringList badges = iterator.value().toString().split(',');
-
-    for (QString badge : badges) {
-        if (badge.isEmpty()) {
+    for (const TagRef &badgeRef : splitTagRef(badges, ',')) {
+        if (badgeRef.isEmpty()) {
             continue;
         }
 
+        // badge names and versions are ascii
+        QString badge = QString::fromLatin1(badgeRef.data, badgeRef.size);
+
         if (badge.startsWith("bits/")) {
-            if (!singletons::ResourceManager::getInstance().dynamicBadgesLoaded) {
+            if (!this->snapshot.badgeSets) {
                 // Do nothing
                 continue;
             }
@@ -548,17 +527,20 @@ void TwitchMessageBuilder::appendTwitchBadges()
             std::string versionKey = cheerAmountQS.toStdString();
 
             // Try to fetch channel-specific bit badge
-            try {
-                const auto &badge = channelResources.badgeSets.at("bits").versions.at(versionKey);
-                this->emplace<ImageElement>(badge.badgeImage1x, MessageElement::BadgeVanity);
-                continue;
-            } catch (const std::out_of_range &) {
-                // Channel does not contain a special bit badge for this version
+            if (channelResources) {
+                try {
+                    const auto &badge =
+                        channelResources->badgeSets.at("bits").versions.at(versionKey);
+                    this->emplace<ImageElement>(badge.badgeImage1x, MessageElement::BadgeVanity);
+                    continue;
+                } catch (const std::out_of_range &) {
+                    // Channel does not contain a special bit badge for this version
+                }
             }
 
             // Use default bit badge
             try {
-                const auto &badge = resourceManager.badgeSets.at("bits").versions.at(versionKey);
+                const auto &badge = this->snapshot.badgeSets->at("bits").versions.at(versionKey);
                 this->emplace<ImageElement>(badge.badgeImage1x, MessageElement::BadgeVanity);
             } catch (const std::out_of_range &) {
                 debug::Log("No default bit badge for version {} found", versionKey);
@@ -605,13 +587,13 @@ void TwitchMessageBuilder::appendTwitchBadges()
                 } break;
             }
         } else if (badge.startsWith("subscriber/")) {
-            if (channelResources.loaded == false) {
+            if (!channelResources || channelResources->loaded == false) {
                 qDebug() << "Channel resources are not loaded, can't add the subscriber badge";
                 continue;
             }
 
-            auto badgeSetIt = channelResources.badgeSets.find("subscriber");
-            if (badgeSetIt == channelResources.badgeSets.end()) {
+            auto badgeSetIt = channelResources->badgeSets.find("subscriber");
+            if (badgeSetIt == channelResources->badgeSets.end()) {
                 // Fall back to default badge
                 this->emplace<ImageElement>(resourceManager.badgeSubscriber,
                                             MessageElement::BadgeSubscription)
@@ -639,7 +621,7 @@ void TwitchMessageBuilder::appendTwitchBadges()
                                         MessageElement::BadgeSubscription)
                 ->setTooltip("Twitch " + QString::fromStdString(badgeVersion.title));
         } else {
-            if (!resourceManager.dynamicBadgesLoaded) {
+            if (!this->snapshot.badgeSets) {
                 // Do nothing
                 continue;
             }
@@ -657,7 +639,7 @@ void TwitchMessageBuilder::appendTwitchBadges()
             std::string versionKey = parts[1].toStdString();
 
             try {
-                auto &badgeSet = resourceManager.badgeSets.at(badgeSetKey);
+                auto &badgeSet = this->snapshot.badgeSets->at(badgeSetKey);
 
                 try {
                     auto &badgeVersion = badgeSet.versions.at(versionKey);
@@ -678,7 +660,11 @@ void TwitchMessageBuilder::appendTwitchBadges()
 
 void TwitchMessageBuilder::appendChatterinoBadges()
 {
-    auto &badges = singletons::ResourceManager::getInstance().chatterinoBadges;
+    if (!this->snapshot.chatterinoBadges) {
+        return;
+    }
+
+    auto &badges = *this->snapshot.chatterinoBadges;
     auto it = badges.find(this->userName.toStdString());
 
     if (it == badges.end()) {
@@ -694,10 +680,8 @@ void TwitchMessageBuilder::appendChatterinoBadges()
 bool TwitchMessageBuilder::tryParseCheermote(const QString &string)
 {
     // Try to parse custom cheermotes
-    const auto &channelResources =
-        singletons::ResourceManager::getInstance().channels[this->roomID];
-    if (channelResources.loaded) {
-        for (const auto &cheermoteSet : channelResources.cheermoteSets) {
+    if (this->snapshot.channelResources && this->snapshot.channelResources->loaded) {
+        for (const auto &cheermoteSet : this->snapshot.channelResources->cheermoteSets) {
             auto match = cheermoteSet.regex.match(string);
             if (!match.hasMatch()) {
                 continue;
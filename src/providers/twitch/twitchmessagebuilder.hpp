@@ -2,12 +2,14 @@
 
 #include "messages/messagebuilder.hpp"
 #include "messages/messageparseargs.hpp"
+#include "providers/twitch/twitchtags.hpp"
 #include "singletons/emotemanager.hpp"
+#include "singletons/resourcemanager.hpp"
 
 #include <IrcMessage>
 
+#include <QByteArray>
 #include <QString>
-#include <QVariant>
 
 namespace chatterino {
 class Channel;
@@ -25,6 +27,23 @@ public:
         UsernameAndLocalizedName = 3,  // Username (Localized name)
     };
 
+    // what the builder needs from the singletons that are changed on the gui thread, taken
+    // before build so build can run on any thread
+    struct Snapshot {
+        // badges and cheermotes of the channel, empty if they aren't loaded yet
+        std::shared_ptr<const singletons::ResourceManager::Channel> channelResources;
+        // null if they aren't loaded yet
+        std::shared_ptr<const singletons::ResourceManager::BadgeSets> badgeSets;
+        std::shared_ptr<const singletons::ResourceManager::ChatterinoBadges> chatterinoBadges;
+
+        QColor systemColor;
+        QString currentUserName;
+        QColor currentUserColor;
+
+        // call it on the gui thread
+        static Snapshot take(Channel *channel);
+    };
+
     TwitchMessageBuilder() = delete;
 
     explicit TwitchMessageBuilder(Channel *_channel, const Communi::IrcPrivateMessage *_ircMessage,
@@ -36,16 +55,27 @@ public:
     TwitchChannel *twitchChannel;
     const Communi::IrcMessage *ircMessage;
     messages::MessageParseArgs args;
-    const QVariantMap tags;
+    // the tags point into the raw line
+    const QByteArray rawLine;
+    const TwitchTags tags;
 
     QString messageID;
     QString userName;
 
+    // has to be set before build
+    Snapshot snapshot;
+
     bool isIgnored() const;
+    // only creates the message and can run on any thread
     messages::MessagePtr build();
+    // plays the highlight sound, alerts the window, sets the room id of the channel and the color
+    // of the current user, call it on the gui thread after build
+    void finishOnGuiThread();
 
 private:
     QString roomID;
+    bool highlightSound = false;
+    bool highlightAlert = false;
 
     QColor usernameColor;
     const QString originalMessage;
@@ -59,7 +89,7 @@ private:
     void appendUsername();
     void parseHighlights();
 
-    void appendTwitchEmote(const Communi::IrcMessage *ircMessage, const QString &emote,
+    void appendTwitchEmote(const TwitchEmoteOccurence &emote,
                            std::vector<std::pair<long, util::EmoteData>> &vec);
     bool tryAppendEmote(QString &emoteString);
 
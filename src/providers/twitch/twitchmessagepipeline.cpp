@@ -0,0 +1,177 @@
+#include "providers/twitch/twitchmessagepipeline.hpp"
+#include "messages/messageparseargs.hpp"
+#include "providers/twitch/twitchmessagebuilder.hpp"
+#include "providers/twitch/twitchserver.hpp"
+#include "util/posttothread.hpp"
+
+#include <IrcMessage>
+#include <QThread>
+
+#include <algorithm>
+#include <cassert>
+
+namespace chatterino {
+namespace providers {
+namespace twitch {
+
+namespace {
+
+// a worker builds this many messages of a channel before it lets other channels use the thread
+const int MAX_MESSAGES_PER_RUN = 64;
+
+}  // namespace
+
+TwitchMessagePipeline::TwitchMessagePipeline()
+{
+    // leave a core to the gui thread
+    this->pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+TwitchMessagePipeline::~TwitchMessagePipeline()
+{
+    this->pool.waitForDone();
+}
+
+void TwitchMessagePipeline::addMessage(ChannelPtr channel, Communi::IrcPrivateMessage *message)
+{
+    // the connection deletes its message after the signal
+    auto job = std::make_unique<Job>();
+    job->channel = channel;
+    job->ircMessage.reset(static_cast<Communi::IrcPrivateMessage *>(message->clone()));
+    job->snapshot = TwitchMessageBuilder::Snapshot::take(channel.get());
+
+    this->addJob(std::move(job));
+}
+
+void TwitchMessagePipeline::addAction(ChannelPtr channel, std::function<void()> action)
+{
+    auto job = std::make_unique<Job>();
+    job->channel = channel;
+    job->action = std::move(action);
+
+    this->addJob(std::move(job));
+}
+
+void TwitchMessagePipeline::addJob(std::unique_ptr<Job> job)
+{
+    Channel *key = job->channel.get();
+
+    std::lock_guard<std::mutex> lock(this->queuesMutex);
+
+    ChannelQueue &queue = this->queues[key];
+    queue.jobs.push_back(std::move(job));
+
+    // only one worker builds the messages of a channel at a time
+    if (!queue.running) {
+        queue.running = true;
+
+        this->pool.start(new util::LambdaRunnable([this, key] {
+            this->buildMessages(key);  //
+        }));
+    }
+}
+
+void TwitchMessagePipeline::buildMessages(Channel *channel)
+{
+    for (int i = 0; i < MAX_MESSAGES_PER_RUN; i++) {
+        std::unique_ptr<Job> job;
+
+        {
+            std::lock_guard<std::mutex> lock(this->queuesMutex);
+
+            auto it = this->queues.find(channel);
+            assert(it != this->queues.end());
+
+            if (it->second.jobs.empty()) {
+                this->queues.erase(it);
+                return;
+            }
+
+            job = std::move(it->second.jobs.front());
+            it->second.jobs.pop_front();
+        }
+
+        // actions are only passed on in order
+        if (job->action) {
+            this->addFinished(std::move(job));
+            continue;
+        }
+
+        messages::MessageParseArgs args;
+
+        job->builder =
+            std::make_unique<TwitchMessageBuilder>(job->channel.get(), job->ircMessage.get(), args);
+        job->builder->snapshot = job->snapshot;
+
+        if (job->builder->isIgnored()) {
+            job->builder.reset();
+        } else {
+            job->message = job->builder->build();
+        }
+
+        this->addFinished(std::move(job));
+    }
+
+    // continue at the end of the pool's queue
+    this->pool.start(new util::LambdaRunnable([this, channel] {
+        this->buildMessages(channel);  //
+    }));
+}
+
+void TwitchMessagePipeline::addFinished(std::unique_ptr<Job> job)
+{
+    std::lock_guard<std::mutex> lock(this->finishedMutex);
+
+    this->finished.push_back(std::move(job));
+
+    // everything that finishes until the gui thread gets to it is delivered together
+    if (!this->deliveryQueued) {
+        this->deliveryQueued = true;
+
+        util::postToThread([this] { this->deliverFinished(); });
+    }
+}
+
+void TwitchMessagePipeline::deliverFinished()
+{
+    std::vector<std::unique_ptr<Job>> batch;
+
+    {
+        std::lock_guard<std::mutex> lock(this->finishedMutex);
+
+        batch.swap(this->finished);
+        this->deliveryQueued = false;
+    }
+
+    auto &server = TwitchServer::getInstance();
+
+    for (const std::unique_ptr<Job> &job : batch) {
+        if (job->action) {
+            job->action();
+            continue;
+        }
+
+        if (!job->message) {
+            continue;
+        }
+
+        job->builder->finishOnGuiThread();
+
+        if (job->message->flags & messages::Message::Highlighted) {
+            server.mentionsChannel->addMessage(job->message);
+        }
+
+        // fast channels might only show some of their messages
+        auto twitchChannel = dynamic_cast<TwitchChannel *>(job->channel.get());
+
+        if (twitchChannel != nullptr) {
+            twitchChannel->addChatMessage(job->message);
+        } else {
+            job->channel->addMessage(job->message);
+        }
+    }
+}
+
+}  // namespace twitch
+}  // namespace providers
+}  // namespace chatterino
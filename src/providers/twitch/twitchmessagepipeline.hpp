@@ -0,0 +1,76 @@
+#pragma once
+
+#include "channel.hpp"
+#include "providers/twitch/twitchmessagebuilder.hpp"
+
+#include <QThreadPool>
+#include <boost/noncopyable.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Communi {
+class IrcPrivateMessage;
+}
+
+namespace chatterino {
+namespace providers {
+namespace twitch {
+
+// Builds the messages of the read connection on a pool of worker threads. The messages of a
+// channel are built one after another so they keep their order, different channels are built in
+// parallel. The finished messages are added to their channels on the gui thread in batches.
+// Other events of a channel are queued with the messages, so they apply to every message that
+// was received before them.
+class TwitchMessagePipeline : boost::noncopyable
+{
+public:
+    TwitchMessagePipeline();
+    ~TwitchMessagePipeline();
+
+    // has to be called on the gui thread, the message is copied
+    void addMessage(ChannelPtr channel, Communi::IrcPrivateMessage *message);
+    // has to be called on the gui thread, the action runs on the gui thread after the messages
+    // that were added to the channel before
+    void addAction(ChannelPtr channel, std::function<void()> action);
+
+private:
+    struct Job {
+        ChannelPtr channel;
+        // set for actions instead of the message
+        std::function<void()> action;
+        std::unique_ptr<Communi::IrcPrivateMessage> ircMessage;
+        // taken on the gui thread when the message is added
+        TwitchMessageBuilder::Snapshot snapshot;
+        // empty if the message is ignored
+        std::unique_ptr<TwitchMessageBuilder> builder;
+        messages::MessagePtr message;
+    };
+
+    struct ChannelQueue {
+        std::deque<std::unique_ptr<Job>> jobs;
+        bool running = false;
+    };
+
+    QThreadPool pool;
+
+    std::mutex queuesMutex;
+    std::unordered_map<Channel *, ChannelQueue> queues;
+
+    std::mutex finishedMutex;
+    std::vector<std::unique_ptr<Job>> finished;
+    bool deliveryQueued = false;
+
+    void addJob(std::unique_ptr<Job> job);
+    void buildMessages(Channel *channel);
+    void addFinished(std::unique_ptr<Job> job);
+    void deliverFinished();
+};
+
+}  // namespace twitch
+}  // namespace providers
+}  // namespace chatterino
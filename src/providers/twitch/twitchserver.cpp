@@ -18,6 +18,9 @@ TwitchServer::TwitchServer()
     : whispersChannel(new Channel("/mentions"))
     , mentionsChannel(new Channel("/mentions"))
 {
+    this->whispersChannel->useScrollbackBudget();
+    this->mentionsChannel->useScrollbackBudget();
+
     AccountManager::getInstance().Twitch.userChanged.connect([this]() {  //
         util::postToThread([this] { this->connect(); });
     });
@@ -79,21 +82,11 @@ void TwitchServer::privateMessageReceived(IrcPrivateMessage *message)
         return;
     }
 
-    messages::MessageParseArgs args;
-
-    TwitchMessageBuilder builder(chan.get(), message, args);
-
     // XXX: Thread-safety
     chan->completionModel.addUser(message->nick());
 
-    if (!builder.isIgnored()) {
-        messages::MessagePtr _message = builder.build();
-        if (_message->flags & messages::Message::Highlighted) {
-            TwitchServer::getInstance().mentionsChannel->addMessage(_message);
-        }
-
-        chan->addMessage(_message);
-    }
+    // the message is built on a worker thread and added to the channel afterwards
+    this->messagePipeline.addMessage(chan, message);
 }
 
 void TwitchServer::messageReceived(IrcMessage *message)
@@ -147,6 +140,11 @@ std::shared_ptr<Channel> TwitchServer::getCustomChannel(const QString &channelNa
     return nullptr;
 }
 
+void TwitchServer::runAfterPendingMessages(ChannelPtr channel, std::function<void()> action)
+{
+    this->messagePipeline.addAction(channel, std::move(action));
+}
+
 void TwitchServer::forEachChannelAndSpecialChannels(std::function<void(ChannelPtr)> func)
 {
     std::lock_guard<std::mutex> lock(this->channelMutex);
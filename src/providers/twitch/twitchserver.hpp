@@ -5,6 +5,7 @@
 #include "providers/irc/abstractircserver.hpp"
 #include "providers/twitch/twitchaccount.hpp"
 #include "providers/twitch/twitchchannel.hpp"
+#include "providers/twitch/twitchmessagepipeline.hpp"
 
 namespace chatterino {
 namespace providers {
@@ -19,6 +20,10 @@ public:
     // fourtf: ugh
     void forEachChannelAndSpecialChannels(std::function<void(ChannelPtr)> func);
 
+    // runs the action once the messages the channel received before were added to it, so
+    // moderation events also apply to messages that are still being built
+    void runAfterPendingMessages(ChannelPtr channel, std::function<void()> action);
+
     const ChannelPtr whispersChannel;
     const ChannelPtr mentionsChannel;
 
@@ -32,6 +37,9 @@ protected:
     virtual void writeConnectionMessageReceived(Communi::IrcMessage *message) override;
 
     virtual std::shared_ptr<Channel> getCustomChannel(const QString &channelname) override;
+
+private:
+    TwitchMessagePipeline messagePipeline;
 };
 }  // namespace twitch
 }  // namespace providers
@@ -0,0 +1,214 @@
+#include "providers/twitch/twitchtags.hpp"
+
+#include <climits>
+#include <cstring>
+
+namespace chatterino {
+namespace providers {
+namespace twitch {
+
+bool TagRef::operator==(const char *str) const
+{
+    int length = (int)std::strlen(str);
+
+    return length == this->size && std::memcmp(this->data, str, length) == 0;
+}
+
+bool TagRef::startsWith(const char *str) const
+{
+    int length = (int)std::strlen(str);
+
+    return length <= this->size && std::memcmp(this->data, str, length) == 0;
+}
+
+TagRef TagRef::mid(int position) const
+{
+    if (position >= this->size) {
+        return TagRef(this->data + this->size, 0);
+    }
+
+    return TagRef(this->data + position, this->size - position);
+}
+
+QString TagRef::toString() const
+{
+    // most values don't contain escape sequences
+    if (std::memchr(this->data, '\\', this->size) == nullptr) {
+        return QString::fromUtf8(this->data, this->size);
+    }
+
+    QByteArray unescaped;
+    unescaped.reserve(this->size);
+
+    for (int i = 0; i < this->size; i++) {
+        char c = this->data[i];
+
+        if (c != '\\') {
+            unescaped.append(c);
+            continue;
+        }
+
+        // a backslash at the end is dropped
+        if (++i == this->size) {
+            break;
+        }
+
+        switch (this->data[i]) {
+            case ':':
+                unescaped.append(';');
+                break;
+            case 's':
+                unescaped.append(' ');
+                break;
+            case 'r':
+                unescaped.append('\r');
+                break;
+            case 'n':
+                unescaped.append('\n');
+                break;
+            default:
+                unescaped.append(this->data[i]);
+                break;
+        }
+    }
+
+    return QString::fromUtf8(unescaped);
+}
+
+qint64 TagRef::toNumber() const
+{
+    // more digits could overflow
+    if (this->size == 0 || this->size > 18) {
+        return -1;
+    }
+
+    qint64 value = 0;
+
+    for (int i = 0; i < this->size; i++) {
+        char c = this->data[i];
+
+        if (c < '0' || c > '9') {
+            return -1;
+        }
+
+        value = value * 10 + (c - '0');
+    }
+
+    return value;
+}
+
+std::vector<TagRef> splitTagRef(TagRef ref, char separator)
+{
+    std::vector<TagRef> parts;
+
+    const char *start = ref.data;
+    const char *end = ref.data + ref.size;
+
+    while (true) {
+        auto next = (const char *)std::memchr(start, separator, end - start);
+
+        if (next == nullptr) {
+            parts.emplace_back(start, (int)(end - start));
+            break;
+        }
+
+        parts.emplace_back(start, (int)(next - start));
+        start = next + 1;
+    }
+
+    return parts;
+}
+
+TwitchTags::TwitchTags(const QByteArray &line)
+{
+    if (!line.startsWith('@')) {
+        return;
+    }
+
+    const char *start = line.constData() + 1;
+    const char *end = line.constData() + line.size();
+
+    // the tags end at the first space
+    auto space = (const char *)std::memchr(start, ' ', end - start);
+
+    if (space != nullptr) {
+        end = space;
+    }
+
+    for (const TagRef &tag : splitTagRef(TagRef(start, (int)(end - start)), ';')) {
+        auto equals = (const char *)std::memchr(tag.data, '=', tag.size);
+
+        if (equals == nullptr) {
+            this->tags.push_back({tag, TagRef(tag.data + tag.size, 0)});
+        } else {
+            int keySize = (int)(equals - tag.data);
+
+            this->tags.push_back(
+                {TagRef(tag.data, keySize), TagRef(equals + 1, tag.size - keySize - 1)});
+        }
+    }
+}
+
+bool TwitchTags::contains(const char *key) const
+{
+    return !this->get(key).isNull();
+}
+
+TagRef TwitchTags::get(const char *key) const
+{
+    for (const Tag &tag : this->tags) {
+        if (tag.key == key) {
+            return tag.value;
+        }
+    }
+
+    return TagRef();
+}
+
+std::vector<TwitchEmoteOccurence> parseTwitchEmotes(TagRef emotes)
+{
+    std::vector<TwitchEmoteOccurence> occurences;
+
+    if (emotes.isEmpty()) {
+        return occurences;
+    }
+
+    for (const TagRef &emote : splitTagRef(emotes, '/')) {
+        auto colon = (const char *)std::memchr(emote.data, ':', emote.size);
+
+        if (colon == nullptr) {
+            continue;
+        }
+
+        int idSize = (int)(colon - emote.data);
+        qint64 id = TagRef(emote.data, idSize).toNumber();
+
+        if (id < 0) {
+            continue;
+        }
+
+        for (const TagRef &range : splitTagRef(emote.mid(idSize + 1), ',')) {
+            auto dash = (const char *)std::memchr(range.data, '-', range.size);
+
+            if (dash == nullptr) {
+                continue;
+            }
+
+            int startSize = (int)(dash - range.data);
+            qint64 start = TagRef(range.data, startSize).toNumber();
+            qint64 end = range.mid(startSize + 1).toNumber();
+
+            if (start < 0 || end < 0 || start > INT_MAX || end > INT_MAX) {
+                continue;
+            }
+
+            occurences.push_back({id, (int)start, (int)end});
+        }
+    }
+
+    return occurences;
+}
+
+}  // namespace twitch
+}  // namespace providers
+}  // namespace chatterino
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+namespace providers {
+namespace twitch {
+
+// A part of a raw irc line. It points into the line, so it's only valid as long as the line is.
+struct TagRef {
+    const char *data = nullptr;
+    int size = 0;
+
+    TagRef() = default;
+
+    TagRef(const char *_data, int _size)
+        : data(_data)
+        , size(_size)
+    {
+    }
+
+    bool isNull() const
+    {
+        return this->data == nullptr;
+    }
+
+    bool isEmpty() const
+    {
+        return this->size == 0;
+    }
+
+    bool operator==(const char *str) const;
+    bool startsWith(const char *str) const;
+    TagRef mid(int position) const;
+
+    // unescapes the value and decodes it as utf-8
+    QString toString() const;
+    // returns -1 if the ref isn't a positive decimal number
+    qint64 toNumber() const;
+};
+
+// splits the ref at every separator, empty parts are kept
+std::vector<TagRef> splitTagRef(TagRef ref, char separator);
+
+// The IRCv3 tags of a raw twitch message. They are parsed from the line directly, without the
+// QVariantMap of Communi::IrcMessage::tags.
+class TwitchTags
+{
+public:
+    TwitchTags() = default;
+    // the line has to outlive the tags
+    explicit TwitchTags(const QByteArray &line);
+
+    bool contains(const char *key) const;
+    // returns a null ref if the tag doesn't exist
+    TagRef get(const char *key) const;
+
+private:
+    struct Tag {
+        TagRef key;
+        TagRef value;
+    };
+
+    // twitch sends about 15 tags, a linear search is faster than a map for that
+    std::vector<Tag> tags;
+};
+
+// an occurence of an emote in the "emotes" tag, start and end are inclusive
+struct TwitchEmoteOccurence {
+    qint64 id;
+    int start;
+    int end;
+};
+
+// parses the "emotes" tag, "id:start-end,start-end/id:start-end". occurences that aren't valid
+// numbers are left out.
+std::vector<TwitchEmoteOccurence> parseTwitchEmotes(TagRef emotes);
+
+}  // namespace twitch
+}  // namespace providers
+}  // namespace chatterino
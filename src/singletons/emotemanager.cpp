@@ -561,31 +561,5 @@ util::EmoteData EmoteManager::getCheerImage(long long amount, bool animated)
     return util::EmoteData();
 }
 
-boost::signals2::signal<void()> &EmoteManager::getGifUpdateSignal()
-{
-    if (!this->gifUpdateTimerInitiated) {
-        this->gifUpdateTimerInitiated = true;
-
-        this->gifUpdateTimer.setInterval(30);
-        this->gifUpdateTimer.start();
-
-        this->settingsManager.enableGifAnimations.connect([this](bool enabled, auto) {
-            if (enabled) {
-                this->gifUpdateTimer.start();
-            } else {
-                this->gifUpdateTimer.stop();
-            }
-        });
-
-        QObject::connect(&this->gifUpdateTimer, &QTimer::timeout, [this] {
-            this->gifUpdateTimerSignal();
-            // fourtf:
-            this->windowManager.repaintGifEmotes();
-        });
-    }
-
-    return this->gifUpdateTimerSignal;
-}
-
 }  // namespace singletons
 }  // namespace chatterino
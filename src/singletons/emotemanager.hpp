@@ -1,7 +1,5 @@
 #pragma once
 
-#define GIF_FRAME_LENGTH 33
-
 #include "emojis.hpp"
 #include "messages/image.hpp"
 #include "providers/twitch/emotevalue.hpp"
@@ -17,6 +15,8 @@
 #include <QTimer>
 #include <boost/signals2.hpp>
 
+#include <atomic>
+
 namespace chatterino {
 namespace singletons {
 
@@ -60,8 +60,6 @@ public:
         _generation++;
     }
 
-    boost::signals2::signal<void()> &getGifUpdateSignal();
-
     // Bit badge/emotes?
     util::ConcurrentMap<QString, messages::Image *> miscImageCache;
 
@@ -148,11 +146,8 @@ private:
     /// Chatterino emotes
     util::EmoteMap _chatterinoEmotes;
 
-    boost::signals2::signal<void()> gifUpdateTimerSignal;
-    QTimer gifUpdateTimer;
-    bool gifUpdateTimerInitiated = false;
-
-    int _generation = 0;
+    // invalidates all message layouts, can be incremented from any thread
+    std::atomic<int> _generation{0};
 };
 
 }  // namespace singletons
@@ -1,6 +1,7 @@
 #include "singletons/fontmanager.hpp"
 
 #include <QDebug>
+#include <QTransform>
 #include <QtGlobal>
 
 #ifdef Q_OS_WIN32
@@ -19,21 +20,31 @@
 namespace chatterino {
 namespace singletons {
 
+constexpr int FontManager::maxCachedWords;
+
 FontManager::FontManager()
     : currentFontFamily("/appearance/currentFontFamily", DEFAULT_FONT_FAMILY)
     , currentFontSize("/appearance/currentFontSize", DEFAULT_FONT_SIZE)
 //    , currentFont(this->currentFontFamily.getValue().c_str(), currentFontSize.getValue())
 {
     this->currentFontFamily.connect([this](const std::string &newValue, auto) {
-        this->incGeneration();
-        //        this->currentFont.setFamily(newValue.c_str());
-        this->currentFontByScale.clear();
+        {
+            std::lock_guard<std::mutex> lock(this->fontsMutex);
+
+            this->incGeneration();
+            //        this->currentFont.setFamily(newValue.c_str());
+            this->currentFontByScale.clear();
+        }
         this->fontChanged.invoke();
     });
     this->currentFontSize.connect([this](const int &newValue, auto) {
-        this->incGeneration();
-        //        this->currentFont.setSize(newValue);
-        this->currentFontByScale.clear();
+        {
+            std::lock_guard<std::mutex> lock(this->fontsMutex);
+
+            this->incGeneration();
+            //        this->currentFont.setSize(newValue);
+            this->currentFontByScale.clear();
+        }
         this->fontChanged.invoke();
     });
 }
@@ -45,18 +56,119 @@ FontManager &FontManager::getInstance()
     return instance;
 }
 
-QFont &FontManager::getFont(FontManager::Type type, float scale)
+QFont FontManager::getFont(FontManager::Type type, float scale)
 {
+    std::lock_guard<std::mutex> lock(this->fontsMutex);
+
     //    return this->currentFont.getFont(type);
     return this->getCurrentFont(scale).getFont(type);
 }
 
-QFontMetrics &FontManager::getFontMetrics(FontManager::Type type, float scale)
+QFontMetrics FontManager::getFontMetrics(FontManager::Type type, float scale)
 {
+    std::lock_guard<std::mutex> lock(this->fontsMutex);
+
     //    return this->currentFont.getFontMetrics(type);
     return this->getCurrentFont(scale).getFontMetrics(type);
 }
 
+int FontManager::getWordWidth(Type type, float scale, const QStringRef &word)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->wordsMutex);
+
+        WordData *data = this->findWord(type, scale, word);
+
+        if (data != nullptr && data->width != -1) {
+            return data->width;
+        }
+    }
+
+    int generation = this->getGeneration();
+    // measures the characters of the word in place
+    int width = this->getFontMetrics(type, scale)
+                    .width(QString::fromRawData(word.unicode(), word.size()));
+
+    std::lock_guard<std::mutex> lock(this->wordsMutex);
+
+    // the font might have changed while the word was measured
+    if (generation == this->getGeneration()) {
+        WordData *data = this->findWord(type, scale, word);
+
+        if (data == nullptr) {
+            data = &this->addWord(type, scale, word);
+        }
+
+        data->width = width;
+    }
+
+    return width;
+}
+
+QStaticText FontManager::getStaticText(Type type, float scale, const QString &word)
+{
+    QStringRef wordRef(&word);
+
+    std::lock_guard<std::mutex> lock(this->wordsMutex);
+
+    WordData *data = this->findWord(type, scale, wordRef);
+
+    if (data == nullptr) {
+        data = &this->addWord(type, scale, wordRef);
+    }
+
+    if (!data->hasStaticText) {
+        data->staticText.setText(word);
+        data->staticText.setTextFormat(Qt::PlainText);
+        data->staticText.prepare(QTransform(), this->getFont(type, scale));
+        data->hasStaticText = true;
+    }
+
+    return data->staticText;
+}
+
+uint FontManager::hashWord(Type type, float scale, const QStringRef &word)
+{
+    return ::qHash(word) ^ ::qHash((int)type) ^ ::qHash(scale);
+}
+
+FontManager::WordData *FontManager::findWord(Type type, float scale, const QStringRef &word)
+{
+    uint hash = hashWord(type, scale, word);
+
+    for (auto it = this->words.find(hash); it != this->words.end() && it.key() == hash; ++it) {
+        if (it->type != type || it->scale != scale || it->word != word) {
+            continue;
+        }
+
+        if (it->generation != this->getGeneration()) {
+            this->words.erase(it);
+
+            return nullptr;
+        }
+
+        return &*it;
+    }
+
+    // the cache is simply started over once it grows too big
+    if (this->words.size() >= maxCachedWords) {
+        this->words.clear();
+    }
+
+    return nullptr;
+}
+
+FontManager::WordData &FontManager::addWord(Type type, float scale, const QStringRef &word)
+{
+    WordData data;
+    data.type = type;
+    data.scale = scale;
+    data.word = word.toString();
+    data.generation = this->getGeneration();
+
+    return *this->words.insert(hashWord(type, scale, word), data);
+}
+
 FontManager::FontData &FontManager::Font::getFontData(FontManager::Type type)
 {
     switch (type) {
@@ -3,9 +3,16 @@
 #include <QFont>
 #include <QFontDatabase>
 #include <QFontMetrics>
+#include <QHash>
+#include <QStaticText>
+#include <QStringRef>
 #include <pajlada/settings/setting.hpp>
 #include <pajlada/signals/signal.hpp>
 
+#include <atomic>
+#include <list>
+#include <mutex>
+
 namespace chatterino {
 namespace singletons {
 
@@ -30,8 +37,16 @@ public:
     // FontManager is initialized only once, on first use
     static FontManager &getInstance();
 
-    QFont &getFont(Type type, float scale);
-    QFontMetrics &getFontMetrics(Type type, float scale);
+    // can be called from any thread, messages are laid out on worker threads
+    QFont getFont(Type type, float scale);
+    QFontMetrics getFontMetrics(Type type, float scale);
+
+    // Chat text is very repetitive, so words are only measured and prepared for drawing once
+    // for each font. The width can be requested from any thread, the word is only copied when it
+    // isn't cached yet.
+    int getWordWidth(Type type, float scale, const QStringRef &word);
+    // only call this from the gui thread
+    QStaticText getStaticText(Type type, float scale, const QString &word);
 
     int getGeneration() const
     {
@@ -130,12 +145,35 @@ private:
 
     Font &getCurrentFont(float scale);
 
+    struct WordData {
+        Type type;
+        float scale;
+        QString word;
+
+        int generation = -1;
+        int width = -1;
+        QStaticText staticText;
+        bool hasStaticText = false;
+    };
+
+    static constexpr int maxCachedWords = 20000;
+
+    // the words are looked up by their hash, so a word doesn't have to be copied into a key
+    static uint hashWord(Type type, float scale, const QStringRef &word);
+    // returns nullptr if the word isn't cached for the current font
+    WordData *findWord(Type type, float scale, const QStringRef &word);
+    WordData &addWord(Type type, float scale, const QStringRef &word);
+
     // Future plans:
     // Could have multiple fonts in here, such as "Menu font", "Application font", "Chat font"
 
+    std::mutex fontsMutex;
     std::list<std::pair<float, Font>> currentFontByScale;
 
-    int generation = 0;
+    std::mutex wordsMutex;
+    QMultiHash<uint, WordData> words;
+
+    std::atomic<int> generation{0};
 };
 }  // namespace singletons
 
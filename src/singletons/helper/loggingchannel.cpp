@@ -1,4 +1,5 @@
 #include "loggingchannel.hpp"
+#include "singletons/loggingmanager.hpp"
 
 #include <QDir>
 
@@ -33,6 +34,9 @@ void LoggingChannel::openLogFile()
     if (this->fileHandle.isOpen()) {
         this->fileHandle.flush();
         this->fileHandle.close();
+
+        // the log of the previous day is complete now
+        LoggingManager::getInstance().indexLog(this->fileHandle.fileName());
     }
 
     QString baseFileName = this->channelName + "-" + this->dateString + ".log";
@@ -58,7 +62,7 @@ void LoggingChannel::addMessage(std::shared_ptr<messages::Message> message)
     str.append(now.toString("HH:mm:ss"));
     str.append("] ");
 
-    str.append(message->searchText);
+    str.append(message->getSearchText());
     str.append(endline);
 
     this->appendLine(str);
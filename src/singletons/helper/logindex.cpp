@@ -0,0 +1,372 @@
+#include "singletons/helper/logindex.hpp"
+#include "messages/searchindex.hpp"
+
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+
+#define LOG_INDEX_MAGIC "CLI1"
+#define LOG_INDEX_VERSION 1
+
+namespace chatterino {
+namespace singletons {
+
+namespace {
+
+// the mutex of the saved index, indexLogs, indexLog and searchLogs use the same indexes
+std::mutex &getIndexMutex(const QString &indexPath)
+{
+    static std::mutex mutex;
+    static std::map<QString, std::unique_ptr<std::mutex>> indexMutexes;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::unique_ptr<std::mutex> &indexMutex = indexMutexes[indexPath];
+
+    if (!indexMutex) {
+        indexMutex.reset(new std::mutex);
+    }
+
+    return *indexMutex;
+}
+
+}  // namespace
+
+bool LogLine::parse(const QByteArray &raw, LogLine &line)
+{
+    // [HH:mm:ss] text
+    if (raw.length() < 11 || raw[0] != '[' || raw[9] != ']') {
+        return false;
+    }
+
+    line.time = QTime::fromString(QString::fromLatin1(raw.mid(1, 8)), "HH:mm:ss");
+
+    if (!line.time.isValid()) {
+        return false;
+    }
+
+    line.text = QString::fromUtf8(raw.mid(11)).trimmed();
+
+    // messages from users start with "username: "
+    int index = line.text.indexOf(": ");
+
+    if (index > 0 && line.text.lastIndexOf(' ', index - 1) == -1) {
+        line.user = line.text.left(index).toLower();
+    } else {
+        line.user.clear();
+    }
+
+    return true;
+}
+
+LogIndex::~LogIndex()
+{
+    this->close();
+}
+
+bool LogIndex::update(const QString &logPath)
+{
+    LogIndex index;
+
+    return index.open(logPath);
+}
+
+QByteArray LogIndex::create(const QString &logPath)
+{
+    QFile log(logPath);
+
+    if (!log.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    std::vector<Line> lines;
+    std::map<QByteArray, std::vector<uint32_t>> userLines;
+    std::map<QByteArray, std::vector<uint32_t>> wordLines;
+
+    LogLine line;
+
+    // the log is read line by line so it never has to be in memory as a whole
+    while (!log.atEnd()) {
+        uint32_t offset = (uint32_t)log.pos();
+
+        if (!LogLine::parse(log.readLine(), line)) {
+            continue;
+        }
+
+        uint32_t lineIndex = (uint32_t)lines.size();
+        lines.push_back({offset, (uint32_t)(line.time.msecsSinceStartOfDay() / 1000), noUser});
+
+        if (!line.user.isEmpty()) {
+            userLines[line.user.toUtf8()].push_back(lineIndex);
+        }
+
+        QStringList words = messages::SearchIndex::getWords(line.text);
+        words.removeDuplicates();
+
+        for (const QString &word : words) {
+            wordLines[word.toUtf8()].push_back(lineIndex);
+        }
+    }
+
+    std::vector<Entry> userEntries;
+    std::vector<Entry> wordEntries;
+    std::vector<uint32_t> postings;
+    QByteArray strings;
+
+    auto addEntries = [&](const std::map<QByteArray, std::vector<uint32_t>> &source,
+                          std::vector<Entry> &entries) {
+        for (const auto &pair : source) {
+            entries.push_back({(uint32_t)strings.size(), (uint32_t)pair.first.size(),
+                               (uint32_t)postings.size(), (uint32_t)pair.second.size()});
+
+            strings.append(pair.first);
+            postings.insert(postings.end(), pair.second.begin(), pair.second.end());
+        }
+    };
+
+    addEntries(userLines, userEntries);
+    addEntries(wordLines, wordEntries);
+
+    // the users are numbered in the order of their entries
+    uint32_t userIndex = 0;
+    for (const auto &pair : userLines) {
+        for (uint32_t lineIndex : pair.second) {
+            lines[lineIndex].user = userIndex;
+        }
+        userIndex++;
+    }
+
+    Header header;
+    memcpy(header.magic, LOG_INDEX_MAGIC, 4);
+    header.version = LOG_INDEX_VERSION;
+    header.logSize = (uint64_t)log.size();
+    header.lineCount = (uint32_t)lines.size();
+    header.userCount = (uint32_t)userEntries.size();
+    header.wordCount = (uint32_t)wordEntries.size();
+    header.postingCount = (uint32_t)postings.size();
+    header.stringsSize = (uint32_t)strings.size();
+    header.reserved = 0;
+
+    QByteArray data;
+    data.append((const char *)&header, sizeof(Header));
+    data.append((const char *)lines.data(), (int)(lines.size() * sizeof(Line)));
+    data.append((const char *)userEntries.data(), (int)(userEntries.size() * sizeof(Entry)));
+    data.append((const char *)wordEntries.data(), (int)(wordEntries.size() * sizeof(Entry)));
+    data.append((const char *)postings.data(), (int)(postings.size() * sizeof(uint32_t)));
+    data.append(strings);
+
+    return data;
+}
+
+QString LogIndex::getIndexPath(const QString &logPath)
+{
+    return logPath + ".idx";
+}
+
+bool LogIndex::open(const QString &logPath)
+{
+    this->close();
+
+    QString indexPath = LogIndex::getIndexPath(logPath);
+    this->lock = std::unique_lock<std::mutex>(getIndexMutex(indexPath));
+
+    if (this->map(logPath)) {
+        return true;
+    }
+
+    QByteArray data = LogIndex::create(logPath);
+
+    if (data.isEmpty()) {
+        this->close();
+        return false;
+    }
+
+    // the index is written to a temporary file first, so an index is never half written. nothing
+    // maps it while the lock is held, so it can be replaced on every platform
+    QSaveFile saveFile(indexPath);
+
+    if (!saveFile.open(QIODevice::WriteOnly) || saveFile.write(data) != data.size() ||
+        !saveFile.commit() || !this->map(logPath)) {
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+bool LogIndex::openInMemory(const QString &logPath)
+{
+    this->close();
+
+    this->memory = LogIndex::create(logPath);
+
+    if (!this->setData((const uchar *)this->memory.constData(), this->memory.size(), -1)) {
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+void LogIndex::close()
+{
+    // unmaps the index
+    this->file.close();
+    this->memory.clear();
+
+    this->header = nullptr;
+    this->lines = nullptr;
+    this->users = nullptr;
+    this->words = nullptr;
+    this->postings = nullptr;
+    this->strings = nullptr;
+
+    if (this->lock.owns_lock()) {
+        this->lock.unlock();
+    }
+}
+
+bool LogIndex::map(const QString &logPath)
+{
+    this->file.setFileName(LogIndex::getIndexPath(logPath));
+
+    if (!this->file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const uchar *data = this->file.map(0, this->file.size());
+
+    if (!this->setData(data, this->file.size(), QFileInfo(logPath).size())) {
+        this->file.close();
+        return false;
+    }
+
+    return true;
+}
+
+bool LogIndex::setData(const uchar *data, qint64 size, qint64 logSize)
+{
+    if (data == nullptr || size < (qint64)sizeof(Header)) {
+        return false;
+    }
+
+    auto header = (const Header *)data;
+
+    if (memcmp(header->magic, LOG_INDEX_MAGIC, 4) != 0 || header->version != LOG_INDEX_VERSION ||
+        (logSize != -1 && header->logSize != (uint64_t)logSize)) {
+        return false;
+    }
+
+    qint64 expectedSize = sizeof(Header) + (qint64)header->lineCount * sizeof(Line) +
+                          ((qint64)header->userCount + header->wordCount) * sizeof(Entry) +
+                          (qint64)header->postingCount * sizeof(uint32_t) + header->stringsSize;
+
+    if (size != expectedSize) {
+        return false;
+    }
+
+    this->header = header;
+    this->lines = (const Line *)(this->header + 1);
+    this->users = (const Entry *)(this->lines + this->header->lineCount);
+    this->words = this->users + this->header->userCount;
+    this->postings = (const uint32_t *)(this->words + this->header->wordCount);
+    this->strings = (const char *)(this->postings + this->header->postingCount);
+
+    return true;
+}
+
+uint32_t LogIndex::getLineCount() const
+{
+    return this->header->lineCount;
+}
+
+const LogIndex::Line &LogIndex::getLine(uint32_t index) const
+{
+    return this->lines[index];
+}
+
+std::vector<size_t> LogIndex::findUser(const QString &loginName) const
+{
+    QByteArray key = loginName.toLower().toUtf8();
+
+    const Entry *end = this->users + this->header->userCount;
+    const Entry *entry = this->lowerBound(this->users, end, key);
+
+    if (entry == end || entry->stringLength != (uint32_t)key.size() ||
+        !this->startsWith(*entry, key)) {
+        return std::vector<size_t>();
+    }
+
+    return this->getPostings(*entry);
+}
+
+std::vector<size_t> LogIndex::findWord(const QString &word) const
+{
+    QByteArray key = word.toUtf8();
+
+    const Entry *end = this->words + this->header->wordCount;
+    const Entry *entry = this->lowerBound(this->words, end, key);
+
+    if (entry == end || entry->stringLength != (uint32_t)key.size() ||
+        !this->startsWith(*entry, key)) {
+        return std::vector<size_t>();
+    }
+
+    return this->getPostings(*entry);
+}
+
+std::vector<size_t> LogIndex::findPrefix(const QString &prefix) const
+{
+    QByteArray key = prefix.toUtf8();
+
+    const Entry *end = this->words + this->header->wordCount;
+    std::vector<size_t> lineIndexes;
+    size_t wordCount = 0;
+
+    // the words starting with prefix are next to each other
+    for (const Entry *entry = this->lowerBound(this->words, end, key);
+         entry != end && this->startsWith(*entry, key); entry++) {
+        std::vector<size_t> wordLineIndexes = this->getPostings(*entry);
+        lineIndexes.insert(lineIndexes.end(), wordLineIndexes.begin(), wordLineIndexes.end());
+        wordCount++;
+    }
+
+    // the line indexes of a single word are already sorted
+    if (wordCount > 1) {
+        std::sort(lineIndexes.begin(), lineIndexes.end());
+        lineIndexes.erase(std::unique(lineIndexes.begin(), lineIndexes.end()), lineIndexes.end());
+    }
+
+    return lineIndexes;
+}
+
+const LogIndex::Entry *LogIndex::lowerBound(const Entry *begin, const Entry *end,
+                                            const QByteArray &key) const
+{
+    return std::lower_bound(begin, end, key, [this](const Entry &entry, const QByteArray &value) {
+        int result = memcmp(this->strings + entry.stringOffset, value.constData(),
+                            std::min(entry.stringLength, (uint32_t)value.size()));
+
+        return result < 0 || (result == 0 && entry.stringLength < (uint32_t)value.size());
+    });
+}
+
+bool LogIndex::startsWith(const Entry &entry, const QByteArray &key) const
+{
+    return entry.stringLength >= (uint32_t)key.size() &&
+           memcmp(this->strings + entry.stringOffset, key.constData(), key.size()) == 0;
+}
+
+std::vector<size_t> LogIndex::getPostings(const Entry &entry) const
+{
+    const uint32_t *begin = this->postings + entry.postingOffset;
+
+    return std::vector<size_t>(begin, begin + entry.postingCount);
+}
+
+}  // namespace singletons
+}  // namespace chatterino
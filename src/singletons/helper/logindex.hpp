@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QTime>
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+namespace singletons {
+
+// A message line of a log file
+struct LogLine {
+    QTime time;
+    QString user;
+    QString text;
+
+    // returns false for lines that aren't messages
+    static bool parse(const QByteArray &raw, LogLine &line);
+};
+
+// Compact index of the log file of a single day. It is saved next to the log with the suffix
+// ".idx" and memory mapped while searching, so only the lines that match are read from the log.
+// The log of the current day is still written to, its index is only kept in memory.
+//
+// Layout of the file:
+// - Header
+// - Line[lineCount]         offset, time and user of every message line
+// - Entry[userCount]        login names, sorted by their utf8 bytes
+// - Entry[wordCount]        case folded words, sorted by their utf8 bytes
+// - uint32_t[postingCount]  sorted line indexes of every user and word
+// - char[stringsSize]       utf8 data of the users and words
+class LogIndex : boost::noncopyable
+{
+public:
+    struct Line {
+        uint32_t offset;
+        // seconds since midnight
+        uint32_t time;
+        // index of the user or noUser
+        uint32_t user;
+    };
+
+    static const uint32_t noUser = UINT32_MAX;
+
+    ~LogIndex();
+
+    // builds the saved index of the log if it's missing or the log changed since it was indexed,
+    // returns false if the log couldn't be read
+    static bool update(const QString &logPath);
+    static QString getIndexPath(const QString &logPath);
+
+    // opens the saved index of the log, it's built first if it's missing or outdated. the index
+    // can't be rebuilt by other threads until it's closed again
+    bool open(const QString &logPath);
+    // indexes the log without saving the index, for the log that is still written to
+    bool openInMemory(const QString &logPath);
+    void close();
+
+    uint32_t getLineCount() const;
+    const Line &getLine(uint32_t index) const;
+
+    // sorted line indexes
+    std::vector<size_t> findUser(const QString &loginName) const;
+    std::vector<size_t> findWord(const QString &word) const;
+    std::vector<size_t> findPrefix(const QString &prefix) const;
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t logSize;
+        uint32_t lineCount;
+        uint32_t userCount;
+        uint32_t wordCount;
+        uint32_t postingCount;
+        uint32_t stringsSize;
+        uint32_t reserved;
+    };
+
+    struct Entry {
+        uint32_t stringOffset;
+        uint32_t stringLength;
+        uint32_t postingOffset;
+        uint32_t postingCount;
+    };
+
+    // the index of the log, empty if the log couldn't be read
+    static QByteArray create(const QString &logPath);
+
+    // maps the saved index, returns false if it's missing or outdated
+    bool map(const QString &logPath);
+    // returns false if the data isn't a valid index, or an index of a log with a different size
+    // if logSize isn't -1
+    bool setData(const uchar *data, qint64 size, qint64 logSize);
+
+    // returns the first entry that is not less than key
+    const Entry *lowerBound(const Entry *begin, const Entry *end, const QByteArray &key) const;
+    bool startsWith(const Entry &entry, const QByteArray &key) const;
+    std::vector<size_t> getPostings(const Entry &entry) const;
+
+    // held while the saved index is open, the index is only built and opened with it
+    std::unique_lock<std::mutex> lock;
+    QFile file;
+    QByteArray memory;
+
+    const Header *header = nullptr;
+    const Line *lines = nullptr;
+    const Entry *users = nullptr;
+    const Entry *words = nullptr;
+    const uint32_t *postings = nullptr;
+    const char *strings = nullptr;
+};
+
+}  // namespace singletons
+}  // namespace chatterino
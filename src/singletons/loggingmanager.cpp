@@ -1,11 +1,19 @@
 #include "singletons/loggingmanager.hpp"
+#include "channel.hpp"
 #include "debug/log.hpp"
+#include "messages/searchindex.hpp"
+#include "singletons/helper/logindex.hpp"
 #include "singletons/pathmanager.hpp"
 #include "singletons/settingsmanager.hpp"
+#include "util/posttothread.hpp"
 
+#include <QDate>
 #include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
 #include <QStandardPaths>
 
+#include <algorithm>
 #include <unordered_map>
 
 namespace chatterino {
@@ -41,6 +49,186 @@ void LoggingManager::addMessage(const QString &channelName, messages::MessagePtr
     }
 }
 
+void LoggingManager::indexLogs()
+{
+    QStringList folders = {this->pathManager.channelsLogsFolderPath,
+                           this->pathManager.whispersLogsFolderPath,
+                           this->pathManager.mentionsLogsFolderPath};
+
+    QThreadPool::globalInstance()->start(new util::LambdaRunnable([folders] {
+        QString today = QDate::currentDate().toString("yyyy-MM-dd");
+
+        for (const QString &folder : folders) {
+            QDirIterator it(folder, {"*.log"}, QDir::Files, QDirIterator::Subdirectories);
+
+            while (it.hasNext()) {
+                QString logPath = it.next();
+
+                // the log of today is still being written to
+                if (logPath.endsWith(today + ".log")) {
+                    continue;
+                }
+
+                LogIndex::update(logPath);
+            }
+        }
+    }));
+}
+
+void LoggingManager::indexLog(const QString &logPath)
+{
+    QThreadPool::globalInstance()->start(
+        new util::LambdaRunnable([logPath] { LogIndex::update(logPath); }));
+}
+
+static messages::MessagePtr createLogMessage(const QDate &date, const LogLine &line)
+{
+    messages::MessagePtr message(new messages::Message);
+
+    QDateTime dateTime(date, line.time);
+
+    message->emplaceElement<messages::TextElement>(dateTime.toString("yyyy-MM-dd HH:mm:ss"),
+                                                   messages::MessageElement::Text,
+                                                   messages::MessageColor::System);
+    message->emplaceElement<messages::TextElement>(line.text, messages::MessageElement::Text);
+    message->loginName = line.user;
+    message->messageText =
+        line.user.isEmpty() ? line.text : line.text.mid(line.user.length() + 2);
+
+    return message;
+}
+
+void LoggingManager::searchLogs(const QString &channelName, const QString &query,
+                                std::weak_ptr<Channel> results, size_t maxResults)
+{
+    messages::SearchQuery searchQuery = messages::SearchQuery::parse(query);
+
+    // an empty query would match months of messages
+    if (searchQuery.isEmpty()) {
+        return;
+    }
+
+    QString directory = this->getDirectoryForChannel(channelName);
+
+    // whispers and mentions are saved as "whispers-yyyy-MM-dd.log"
+    QString fileNamePrefix = channelName.mid(channelName.lastIndexOf('/') + 1) + "-";
+
+    QThreadPool::globalInstance()->start(new util::LambdaRunnable([=] {
+        // the dates in the file names sort the same way as the days
+        QStringList fileNames = QDir(directory).entryList({fileNamePrefix + "*.log"}, QDir::Files,
+                                                          QDir::Name | QDir::Reversed);
+
+        size_t hitCount = 0;
+        QString today = QDate::currentDate().toString("yyyy-MM-dd");
+
+        for (const QString &fileName : fileNames) {
+            if (results.expired() || hitCount >= maxResults) {
+                return;
+            }
+
+            QString logPath = directory + QDir::separator() + fileName;
+            QDate date = QDate::fromString(
+                fileName.mid(fileNamePrefix.length(), 10), "yyyy-MM-dd");
+
+            // the log of today is still being written to, a saved index would be outdated with
+            // the next message
+            LogIndex index;
+            bool opened = fileName.endsWith(today + ".log") ? index.openInMemory(logPath)
+                                                            : index.open(logPath);
+
+            if (!opened) {
+                continue;
+            }
+
+            // line indexes that match all parts of the query so far
+            std::vector<size_t> lineIndexes;
+            bool restricted = false;
+
+            auto restrict = [&](std::vector<size_t> matches) {
+                if (restricted) {
+                    messages::intersectPositions(lineIndexes, matches);
+                } else {
+                    lineIndexes = std::move(matches);
+                    restricted = true;
+                }
+            };
+
+            if (!searchQuery.users.isEmpty()) {
+                std::vector<size_t> userLineIndexes;
+
+                for (const QString &user : searchQuery.users) {
+                    std::vector<size_t> matches = index.findUser(user);
+                    userLineIndexes.insert(userLineIndexes.end(), matches.begin(), matches.end());
+                }
+
+                std::sort(userLineIndexes.begin(), userLineIndexes.end());
+                restrict(std::move(userLineIndexes));
+            }
+
+            for (const QString &prefix : searchQuery.prefixes) {
+                restrict(index.findPrefix(prefix));
+            }
+
+            for (const QString &phrase : searchQuery.phrases) {
+                for (const QString &word : messages::SearchIndex::getWords(phrase)) {
+                    restrict(index.findWord(word));
+                }
+            }
+
+            // the phrases don't contain any words
+            if (!restricted) {
+                for (size_t i = 0; i < index.getLineCount(); i++) {
+                    lineIndexes.push_back(i);
+                }
+            }
+
+            if (lineIndexes.empty()) {
+                continue;
+            }
+
+            // only the lines that match are read from the log, starting with the newest one
+            QFile log(logPath);
+            if (!log.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+
+            std::vector<messages::MessagePtr> hits;
+            LogLine line;
+
+            for (auto it = lineIndexes.rbegin();
+                 it != lineIndexes.rend() && hitCount + hits.size() < maxResults; ++it) {
+                if (!log.seek(index.getLine((uint32_t)*it).offset) ||
+                    !LogLine::parse(log.readLine(), line)) {
+                    continue;
+                }
+
+                QString text = line.text.toCaseFolded();
+
+                bool containsPhrases =
+                    std::all_of(searchQuery.phrases.begin(), searchQuery.phrases.end(),
+                                [&text](const QString &phrase) { return text.contains(phrase); });
+
+                if (containsPhrases) {
+                    hits.push_back(createLogMessage(date, line));
+                }
+            }
+
+            if (hits.empty()) {
+                continue;
+            }
+
+            hitCount += hits.size();
+            std::reverse(hits.begin(), hits.end());
+
+            util::postToThread([results, hits]() mutable {
+                if (auto channel = results.lock()) {
+                    channel->addMessagesAtStart(hits);
+                }
+            });
+        }
+    }));
+}
+
 QString LoggingManager::getDirectoryForChannel(const QString &channelName)
 {
     if (channelName.startsWith("/whispers")) {
@@ -8,6 +8,9 @@
 #include <memory>
 
 namespace chatterino {
+
+class Channel;
+
 namespace singletons {
 
 class PathManager;
@@ -23,6 +26,17 @@ public:
 
     void addMessage(const QString &channelName, messages::MessagePtr message);
 
+    // indexes the log files that don't have an up to date index on a background thread
+    void indexLogs();
+    void indexLog(const QString &logPath);
+
+    // searches the logs of the channel on a background thread, from the newest day to the oldest
+    // one, see messages::SearchQuery
+    // the hits of every day are added to the start of results until it is destroyed or maxResults
+    // hits were found
+    void searchLogs(const QString &channelName, const QString &query,
+                    std::weak_ptr<Channel> results, size_t maxResults);
+
 private:
     std::map<QString, std::unique_ptr<LoggingChannel>> loggingChannels;
     QString getDirectoryForChannel(const QString &channelName);
@@ -310,6 +310,18 @@ ResourceManager::BadgeVersion::BadgeVersion(QJsonObject &&root)
 {
 }
 
+std::shared_ptr<const ResourceManager::Channel> ResourceManager::getChannel(
+    const QString &roomID) const
+{
+    auto it = this->channels.find(roomID);
+
+    if (it == this->channels.end()) {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
 void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
 {
     qDebug() << "Load channel data for" << roomID;
@@ -322,12 +334,12 @@ void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
     req.getJSON([this, roomID](QJsonObject &root) {
         QJsonObject sets = root.value("badge_sets").toObject();
 
-        ResourceManager::Channel &ch = this->channels[roomID];
+        auto ch = this->copyChannel(roomID);
 
         for (QJsonObject::iterator it = sets.begin(); it != sets.end(); ++it) {
             QJsonObject versions = it.value().toObject().value("versions").toObject();
 
-            auto &badgeSet = ch.badgeSets[it.key().toStdString()];
+            auto &badgeSet = ch->badgeSets[it.key().toStdString()];
             auto &versionsMap = badgeSet.versions;
 
             for (auto versionIt = std::begin(versions); versionIt != std::end(versions);
@@ -339,18 +351,20 @@ void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
             }
         }
 
-        ch.loaded = true;
+        ch->loaded = true;
+
+        this->channels[roomID] = ch;
     });
 
     QString cheermoteURL = "https://api.twitch.tv/kraken/bits/actions?channel_id=" + roomID;
 
     util::twitch::get2(
         cheermoteURL, QThread::currentThread(), true, [this, roomID](const rapidjson::Document &d) {
-            ResourceManager::Channel &ch = this->channels[roomID];
+            auto ch = this->copyChannel(roomID);
 
-            ParseCheermoteSets(ch.jsonCheermoteSets, d);
+            ParseCheermoteSets(ch->jsonCheermoteSets, d);
 
-            for (auto &set : ch.jsonCheermoteSets) {
+            for (auto &set : ch->jsonCheermoteSets) {
                 CheermoteSet cheermoteSet;
                 cheermoteSet.regex =
                     QRegularExpression("^" + set.prefix.toLower() + "([1-9][0-9]*)$");
@@ -380,11 +394,24 @@ void ResourceManager::loadChannelData(const QString &roomID, bool bypassCache)
                               return lhs.minBits < rhs.minBits;  //
                           });
 
-                ch.cheermoteSets.emplace_back(cheermoteSet);
+                ch->cheermoteSets.emplace_back(cheermoteSet);
             }
+
+            this->channels[roomID] = ch;
         });
 }
 
+std::shared_ptr<ResourceManager::Channel> ResourceManager::copyChannel(const QString &roomID)
+{
+    auto it = this->channels.find(roomID);
+
+    if (it == this->channels.end()) {
+        return std::make_shared<Channel>();
+    }
+
+    return std::make_shared<Channel>(*it->second);
+}
+
 void ResourceManager::loadDynamicTwitchBadges()
 {
     static QString url("https://badges.twitch.tv/v1/badges/global/display?language=en");
@@ -394,10 +421,12 @@ void ResourceManager::loadDynamicTwitchBadges()
     req.getJSON([this](QJsonObject &root) {
         QJsonObject sets = root.value("badge_sets").toObject();
         qDebug() << "badges fetched";
+        auto badgeSets = std::make_shared<BadgeSets>();
+
         for (QJsonObject::iterator it = sets.begin(); it != sets.end(); ++it) {
             QJsonObject versions = it.value().toObject().value("versions").toObject();
 
-            auto &badgeSet = this->badgeSets[it.key().toStdString()];
+            auto &badgeSet = (*badgeSets)[it.key().toStdString()];
             auto &versionsMap = badgeSet.versions;
 
             for (auto versionIt = std::begin(versions); versionIt != std::end(versions);
@@ -409,14 +438,12 @@ void ResourceManager::loadDynamicTwitchBadges()
             }
         }
 
-        this->dynamicBadgesLoaded = true;
+        this->badgeSets = badgeSets;
     });
 }
 
 void ResourceManager::loadChatterinoBadges()
 {
-    this->chatterinoBadges.clear();
-
     static QString url("https://fourtf.com/chatterino/badges.json");
 
     util::NetworkRequest req(url);
@@ -425,6 +452,8 @@ void ResourceManager::loadChatterinoBadges()
     req.getJSON([this](QJsonObject &root) {
         QJsonArray badgeVariants = root.value("badges").toArray();
         qDebug() << "chatbadges fetched";
+        auto chatterinoBadges = std::make_shared<ChatterinoBadges>();
+
         for (QJsonArray::iterator it = badgeVariants.begin(); it != badgeVariants.end(); ++it) {
             QJsonObject badgeVariant = it->toObject();
             const std::string badgeVariantTooltip =
@@ -439,10 +468,11 @@ void ResourceManager::loadChatterinoBadges()
             for (QJsonArray::iterator it = badgeVariantUsers.begin(); it != badgeVariantUsers.end();
                  ++it) {
                 const std::string username = it->toString().toStdString();
-                this->chatterinoBadges[username] =
-                    std::shared_ptr<ChatterinoBadge>(badgeVariantPtr);
+                (*chatterinoBadges)[username] = badgeVariantPtr;
             }
         }
+
+        this->chatterinoBadges = chatterinoBadges;
     });
 }
 
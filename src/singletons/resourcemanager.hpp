@@ -61,9 +61,11 @@ public:
         std::map<std::string, BadgeVersion> versions;
     };
 
-    std::map<std::string, BadgeSet> badgeSets;
+    typedef std::map<std::string, BadgeSet> BadgeSets;
 
-    bool dynamicBadgesLoaded = false;
+    // the global badges, null until they are loaded. replaced instead of changed like the
+    // channels below, so the message builders can keep using them on the worker threads
+    std::shared_ptr<const BadgeSets> badgeSets;
 
     messages::Image *buttonBan;
     messages::Image *buttonTimeout;
@@ -106,7 +108,7 @@ public:
     };
 
     struct Channel {
-        std::map<std::string, BadgeSet> badgeSets;
+        BadgeSets badgeSets;
         std::vector<JSONCheermoteSet> jsonCheermoteSets;
         std::vector<CheermoteSet> cheermoteSets;
 
@@ -114,7 +116,12 @@ public:
     };
 
     //       channelId
-    std::map<QString, Channel> channels;
+    // a channel is replaced instead of changed once it was added, so the message builders can
+    // keep using it on the worker threads
+    std::map<QString, std::shared_ptr<const Channel>> channels;
+
+    // returns nullptr if nothing was loaded for the channel yet, call it on the gui thread
+    std::shared_ptr<const Channel> getChannel(const QString &roomID) const;
 
     // Chatterino badges
     struct ChatterinoBadge {
@@ -128,12 +135,19 @@ public:
         messages::Image *image;
     };
 
-    //       username
-    std::map<std::string, std::shared_ptr<ChatterinoBadge>> chatterinoBadges;
+    //               username
+    typedef std::map<std::string, std::shared_ptr<ChatterinoBadge>> ChatterinoBadges;
+
+    // null until they are loaded, replaced instead of changed like the channels
+    std::shared_ptr<const ChatterinoBadges> chatterinoBadges;
 
     void loadChannelData(const QString &roomID, bool bypassCache = false);
     void loadDynamicTwitchBadges();
     void loadChatterinoBadges();
+
+private:
+    // a copy of the channel that can be changed and replaces it afterwards
+    std::shared_ptr<Channel> copyChannel(const QString &roomID);
 };
 
 }  // namespace singletons
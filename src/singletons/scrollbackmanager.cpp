@@ -0,0 +1,118 @@
+#include "singletons/scrollbackmanager.hpp"
+#include "channel.hpp"
+#include "singletons/settingsmanager.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+namespace singletons {
+
+namespace {
+
+// used for channels that don't have any messages yet
+constexpr double DEFAULT_MESSAGE_SIZE = 1024;
+
+constexpr float VISIBLE_WEIGHT = 8.f;
+constexpr float RECENTLY_VISIBLE_WEIGHT = 2.f;
+constexpr float HIDDEN_WEIGHT = 1.f;
+
+}  // namespace
+
+constexpr size_t ScrollbackManager::minMessageLimit;
+constexpr size_t ScrollbackManager::maxMessageLimit;
+
+ScrollbackManager::ScrollbackManager()
+{
+    // the average size of the messages and the time since a channel was visible change over time
+    this->rebalanceTimer.setInterval(30 * 1000);
+    QObject::connect(&this->rebalanceTimer, &QTimer::timeout, [this] { this->rebalance(); });
+    this->rebalanceTimer.start();
+
+    this->queuedRebalanceTimer.setInterval(1000);
+    this->queuedRebalanceTimer.setSingleShot(true);
+    QObject::connect(&this->queuedRebalanceTimer, &QTimer::timeout,
+                     [this] { this->rebalance(); });
+
+    SettingManager::getInstance().scrollbackMemoryBudget.connect(
+        [this](auto, auto) { this->queueRebalance(); });
+}
+
+ScrollbackManager &ScrollbackManager::getInstance()
+{
+    static ScrollbackManager instance;
+    return instance;
+}
+
+void ScrollbackManager::addChannel(Channel *channel)
+{
+    std::lock_guard<std::mutex> lock(this->channelsMutex);
+
+    this->channels.push_back(channel);
+}
+
+void ScrollbackManager::removeChannel(Channel *channel)
+{
+    std::lock_guard<std::mutex> lock(this->channelsMutex);
+
+    this->channels.erase(std::remove(this->channels.begin(), this->channels.end(), channel),
+                         this->channels.end());
+}
+
+void ScrollbackManager::queueRebalance()
+{
+    if (!this->queuedRebalanceTimer.isActive()) {
+        this->queuedRebalanceTimer.start();
+    }
+}
+
+void ScrollbackManager::rebalance()
+{
+    std::lock_guard<std::mutex> lock(this->channelsMutex);
+
+    if (this->channels.empty()) {
+        return;
+    }
+
+    double budget = std::max(1, SettingManager::getInstance().scrollbackMemoryBudget.getValue()) *
+                    1024. * 1024.;
+
+    std::vector<float> weights;
+    weights.reserve(this->channels.size());
+    float totalWeight = 0;
+
+    for (Channel *channel : this->channels) {
+        weights.push_back(this->getChannelWeight(channel));
+        totalWeight += weights.back();
+    }
+
+    for (size_t i = 0; i < this->channels.size(); i++) {
+        Channel *channel = this->channels[i];
+
+        size_t count = channel->getMessageCount();
+        double averageSize = count == 0 ? DEFAULT_MESSAGE_SIZE
+                                        : (double)channel->getMessagesMemoryUsage() / count;
+
+        double share = budget * weights[i] / totalWeight;
+        size_t limit = (size_t)(share / std::max(averageSize, 1.));
+
+        channel->setMessageLimit(std::min(std::max(limit, minMessageLimit), maxMessageLimit));
+    }
+}
+
+float ScrollbackManager::getChannelWeight(Channel *channel) const
+{
+    if (channel->getVisibleViewCount() > 0) {
+        return VISIBLE_WEIGHT;
+    }
+
+    auto hiddenFor = std::chrono::steady_clock::now() - channel->getLastVisibleTime();
+
+    if (hiddenFor < std::chrono::minutes(10)) {
+        return RECENTLY_VISIBLE_WEIGHT;
+    }
+
+    return HIDDEN_WEIGHT;
+}
+
+}  // namespace singletons
+}  // namespace chatterino
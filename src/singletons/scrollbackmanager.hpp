@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QTimer>
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+
+class Channel;
+
+namespace singletons {
+
+// Splits the memory budget for messages between the channels that use it by changing their
+// message limits.
+// Channels that are shown in a split get the biggest share, channels that have been hidden for a
+// while shrink first.
+class ScrollbackManager : boost::noncopyable
+{
+    ScrollbackManager();
+
+public:
+    static ScrollbackManager &getInstance();
+
+    static constexpr size_t minMessageLimit = 100;
+    static constexpr size_t maxMessageLimit = 20000;
+
+    void addChannel(Channel *channel);
+    void removeChannel(Channel *channel);
+
+    // rebalances shortly after, multiple calls are merged into one rebalance
+    void queueRebalance();
+    void rebalance();
+
+private:
+    float getChannelWeight(Channel *channel) const;
+
+    std::mutex channelsMutex;
+    std::vector<Channel *> channels;
+
+    QTimer rebalanceTimer;
+    QTimer queuedRebalanceTimer;
+};
+
+}  // namespace singletons
+}  // namespace chatterino
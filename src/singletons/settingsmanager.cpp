@@ -1,5 +1,6 @@
 #include "singletons/settingsmanager.hpp"
 #include "debug/log.hpp"
+#include "singletons/accountmanager.hpp"
 #include "singletons/pathmanager.hpp"
 #include "singletons/resourcemanager.hpp"
 #include "singletons/windowmanager.hpp"
@@ -17,8 +18,10 @@ void _registerSetting(std::weak_ptr<pajlada::Settings::ISettingData> setting)
 }
 
 SettingManager::SettingManager()
-    : snapshot(nullptr)
+    : _moderationActions(new std::vector<ModerationAction>)
+    , snapshot(nullptr)
     , _ignoredKeywords(new std::vector<QString>)
+    , _highlightMatcher(new HighlightMatcher)
 {
     this->wordFlagsListener.addSetting(this->showTimestamps);
     this->wordFlagsListener.addSetting(this->showBadges);
@@ -33,6 +36,12 @@ SettingManager::SettingManager()
     this->moderationActions.connect([this](auto, auto) { this->updateModerationActions(); });
     this->ignoredKeywords.connect([this](auto, auto) { this->updateIgnoredKeywords(); });
 
+    this->highlightProperties.connect([this](auto, auto) { this->updateHighlightMatcher(); });
+    this->highlightUserBlacklist.connect([this](auto, auto) { this->updateHighlightMatcher(); });
+    this->enableHighlightsSelf.connect([this](auto, auto) { this->updateHighlightMatcher(); });
+    this->enableHighlightSound.connect([this](auto, auto) { this->updateHighlightMatcher(); });
+    this->enableHighlightTaskbar.connect([this](auto, auto) { this->updateHighlightMatcher(); });
+
     this->timestampFormat.connect(
         [](auto, auto) { singletons::WindowManager::getInstance().layoutVisibleChatWidgets(); });
 }
@@ -52,6 +61,10 @@ void SettingManager::init()
     QString settingsPath = PathManager::getInstance().settingsFolderPath + "/settings.json";
 
     pajlada::Settings::SettingManager::load(qPrintable(settingsPath));
+
+    // the current user is highlighted by their name
+    AccountManager::getInstance().Twitch.userChanged.connect(
+        [this] { this->updateHighlightMatcher(); });
 }
 
 void SettingManager::updateWordTypeMask()
@@ -136,7 +149,7 @@ void SettingManager::recallSnapshot()
     }
 }
 
-std::vector<ModerationAction> SettingManager::getModerationActions() const
+std::shared_ptr<const std::vector<ModerationAction>> SettingManager::getModerationActions() const
 {
     return this->_moderationActions;
 }
@@ -146,11 +159,18 @@ const std::shared_ptr<std::vector<QString>> SettingManager::getIgnoredKeywords()
     return this->_ignoredKeywords;
 }
 
+std::shared_ptr<const HighlightMatcher> SettingManager::getHighlightMatcher() const
+{
+    std::lock_guard<std::mutex> lock(this->highlightMatcherMutex);
+
+    return this->_highlightMatcher;
+}
+
 void SettingManager::updateModerationActions()
 {
     auto &resources = singletons::ResourceManager::getInstance();
 
-    this->_moderationActions.clear();
+    auto actions = std::make_shared<std::vector<ModerationAction>>();
 
     static QRegularExpression newLineRegex("(\r\n?|\n)+");
     static QRegularExpression replaceRegex("[!/.]");
@@ -198,20 +218,22 @@ void SettingManager::updateModerationActions()
                     line2 = "d";
                 }
 
-                this->_moderationActions.emplace_back(line1, line2, str);
+                actions->emplace_back(line1, line2, str);
             } else {
-                this->_moderationActions.emplace_back(resources.buttonTimeout, str);
+                actions->emplace_back(resources.buttonTimeout, str);
             }
         } else if (str.startsWith("/ban ")) {
-            this->_moderationActions.emplace_back(resources.buttonBan, str);
+            actions->emplace_back(resources.buttonBan, str);
         } else {
             QString xD = str;
 
             xD.replace(replaceRegex, "");
 
-            this->_moderationActions.emplace_back(xD.mid(0, 2), xD.mid(2, 2), str);
+            actions->emplace_back(xD.mid(0, 2), xD.mid(2, 2), str);
         }
     }
+
+    this->_moderationActions = actions;
 }
 
 void SettingManager::updateIgnoredKeywords()
@@ -230,5 +252,29 @@ void SettingManager::updateIgnoredKeywords()
 
     this->_ignoredKeywords = std::shared_ptr<std::vector<QString>>(items);
 }
+
+void SettingManager::updateHighlightMatcher()
+{
+    auto phrases = this->highlightProperties.getValue();
+
+    QString currentUsername = AccountManager::getInstance().Twitch.getCurrent()->getUserName();
+
+    if (this->enableHighlightsSelf && currentUsername.size() > 0) {
+        HighlightPhrase selfHighlight;
+        selfHighlight.key = currentUsername;
+        selfHighlight.sound = this->enableHighlightSound;
+        selfHighlight.alert = this->enableHighlightTaskbar;
+        phrases.emplace_back(std::move(selfHighlight));
+    }
+
+    QStringList blacklist =
+        this->highlightUserBlacklist.getValue().split("\n", QString::SkipEmptyParts);
+
+    auto matcher = std::make_shared<const HighlightMatcher>(phrases, blacklist);
+
+    std::lock_guard<std::mutex> lock(this->highlightMatcherMutex);
+
+    this->_highlightMatcher = matcher;
+}
 }  // namespace singletons
 }  // namespace chatterino
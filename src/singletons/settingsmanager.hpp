@@ -1,5 +1,6 @@
 #pragma once
 
+#include "messages/highlightmatcher.hpp"
 #include "messages/highlightphrase.hpp"
 #include "messages/messageelement.hpp"
 #include "singletons/helper/chatterinosetting.hpp"
@@ -8,6 +9,8 @@
 #include <pajlada/settings/setting.hpp>
 #include <pajlada/settings/settinglistener.hpp>
 
+#include <mutex>
+
 namespace chatterino {
 namespace singletons {
 
@@ -54,6 +57,12 @@ public:
     QStringSetting preferredQuality = {"/behaviour/streamlink/quality", "Choose"};
     QStringSetting streamlinkOpts = {"/behaviour/streamlink/options", ""};
     BoolSetting pauseChatHover = {"/behaviour/pauseChatHover", false};
+    // Memory in megabytes that all channels together may use for their messages
+    IntSetting scrollbackMemoryBudget = {"/behaviour/scrollback/memoryBudget", 64};
+    // Memory in megabytes that buffers of messages which scrolled out of view may keep
+    IntSetting messageBufferMemory = {"/behaviour/scrollback/bufferMemory", 32};
+    // Messages per second after which a channel only shows a sample of its messages, 0 disables it
+    IntSetting firehoseMessageRate = {"/behaviour/firehose/messageRate", 40};
 
     /// Commands
     BoolSetting allowCommandsAtEnd = {"/commands/allowCommandsAtEnd", false};
@@ -114,21 +123,28 @@ public:
     void saveSnapshot();
     void recallSnapshot();
 
-    std::vector<ModerationAction> getModerationActions() const;
+    // replaced as a whole when the setting changes, so layouts can keep using the old ones
+    std::shared_ptr<const std::vector<ModerationAction>> getModerationActions() const;
     const std::shared_ptr<std::vector<QString>> getIgnoredKeywords() const;
+    // can be called from any thread
+    std::shared_ptr<const messages::HighlightMatcher> getHighlightMatcher() const;
 
 signals:
     void wordFlagsChanged();
 
 private:
-    std::vector<ModerationAction> _moderationActions;
+    std::shared_ptr<const std::vector<ModerationAction>> _moderationActions;
     std::unique_ptr<rapidjson::Document> snapshot;
     std::shared_ptr<std::vector<QString>> _ignoredKeywords;
 
+    mutable std::mutex highlightMatcherMutex;
+    std::shared_ptr<const messages::HighlightMatcher> _highlightMatcher;
+
     SettingManager();
 
     void updateModerationActions();
     void updateIgnoredKeywords();
+    void updateHighlightMatcher();
 
     messages::MessageElement::Flags wordFlags = messages::MessageElement::Default;
 
@@ -151,9 +151,21 @@ void ThemeManager::actuallyUpdate(double hue, double multiplier)
     // Selection
     this->messages.selection = isLightTheme() ? QColor(0, 0, 0, 64) : QColor(255, 255, 255, 64);
 
+    auto messageColors = std::make_shared<MessageColors>();
+    messageColors->regular = this->messages.textColors.regular;
+    messageColors->link = this->messages.textColors.link;
+    messageColors->system = this->messages.textColors.system;
+    messageColors->isLight = this->isLight;
+    this->messageColors = messageColors;
+
     this->updated();
 }
 
+std::shared_ptr<const ThemeManager::MessageColors> ThemeManager::getMessageColors() const
+{
+    return this->messageColors;
+}
+
 QColor ThemeManager::blendColors(const QColor &color1, const QColor &color2, qreal ratio)
 {
     int r = color1.red() * (1 - ratio) + color2.red() * ratio;
@@ -164,6 +176,13 @@ QColor ThemeManager::blendColors(const QColor &color1, const QColor &color2, qre
 }
 
 void ThemeManager::normalizeColor(QColor &color)
+{
+    MessageColors colors;
+    colors.isLight = this->isLight;
+    colors.normalizeColor(color);
+}
+
+void ThemeManager::MessageColors::normalizeColor(QColor &color) const
 {
     if (this->isLight) {
         if (color.lightnessF() > 0.5f) {
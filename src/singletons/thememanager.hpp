@@ -6,6 +6,8 @@
 #include <pajlada/settings/setting.hpp>
 #include "util/serialize-custom.hpp"
 
+#include <memory>
+
 namespace chatterino {
 namespace singletons {
 
@@ -100,6 +102,21 @@ public:
     QColor windowBg;
     QColor windowText;
 
+    // the colors the message layouts use, they are laid out on worker threads while the theme
+    // might change on the gui thread
+    struct MessageColors {
+        QColor regular;
+        QColor link;
+        QColor system;
+        bool isLight = false;
+
+        // makes user colors readable on the background of the theme
+        void normalizeColor(QColor &color) const;
+    };
+
+    // replaced instead of changed when the theme is updated, call it on the gui thread
+    std::shared_ptr<const MessageColors> getMessageColors() const;
+
     void normalizeColor(QColor &color);
 
     void update();
@@ -121,6 +138,8 @@ private:
 
     bool isLight = false;
 
+    std::shared_ptr<const MessageColors> messageColors;
+
     pajlada::Signals::NoArgSignal repaintVisibleChatWidgets;
 
     friend class WindowManager;
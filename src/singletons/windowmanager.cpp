@@ -68,11 +68,6 @@ void WindowManager::repaintVisibleChatWidgets(Channel *channel)
     }
 }
 
-void WindowManager::repaintGifEmotes()
-{
-    this->repaintGifs();
-}
-
 // void WindowManager::updateAll()
 //{
 //    if (this->mainWindow != nullptr) {
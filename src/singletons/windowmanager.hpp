@@ -20,7 +20,6 @@ public:
     void initMainWindow();
     void layoutVisibleChatWidgets(Channel *channel = nullptr);
     void repaintVisibleChatWidgets(Channel *channel = nullptr);
-    void repaintGifEmotes();
     // void updateAll();
 
     widgets::Window &getMainWindow();
@@ -32,7 +31,6 @@ public:
 
     void save();
 
-    boost::signals2::signal<void()> repaintGifs;
     boost::signals2::signal<void(Channel *)> layout;
 
 private:
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+namespace util {
+
+// Bump allocator that hands out memory from a few big blocks which are freed together.
+// The destructors of the created objects are not called by the arena, its owner has to do that.
+class Arena : boost::noncopyable
+{
+public:
+    explicit Arena(size_t _firstBlockSize = 1024)
+        : nextBlockSize(_firstBlockSize)
+    {
+    }
+
+    void *allocate(size_t size, size_t alignment)
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+        if (!this->blocks.empty()) {
+            size_t offset = (this->offset + alignment - 1) & ~(alignment - 1);
+
+            if (offset + size <= this->blocks.back().size) {
+                this->offset = offset + size;
+
+                return this->blocks.back().data.get() + offset;
+            }
+        }
+
+        // new blocks are aligned for every type, blocks grow so big messages need few of them
+        size_t blockSize = std::max(this->nextBlockSize, size);
+        this->nextBlockSize *= 2;
+
+        this->blocks.push_back({std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+        this->offset = size;
+
+        return this->blocks.back().data.get();
+    }
+
+    template <typename T, typename... Args>
+    T *create(Args &&... args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "T is over-aligned");
+
+        void *memory = this->allocate(sizeof(T), alignof(T));
+
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t offset = 0;
+    size_t nextBlockSize;
+};
+
+}  // namespace util
+}  // namespace chatterino
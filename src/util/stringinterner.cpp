@@ -0,0 +1,53 @@
+#include "util/stringinterner.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+namespace util {
+
+StringInterner &StringInterner::getInstance()
+{
+    static StringInterner instance;
+    return instance;
+}
+
+QString StringInterner::intern(const QString &str)
+{
+    if (str.isEmpty()) {
+        return str;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto it = this->strings.constFind(str);
+
+    if (it != this->strings.constEnd()) {
+        return *it;
+    }
+
+    if (this->strings.size() >= this->removeUnusedSize) {
+        this->removeUnused();
+    }
+
+    this->strings.insert(str);
+
+    return str;
+}
+
+void StringInterner::removeUnused()
+{
+    for (auto it = this->strings.begin(); it != this->strings.end();) {
+        // the set holds the only reference
+        if (it->isDetached()) {
+            it = this->strings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // strings that are still used are not checked again until the set grew enough
+    this->removeUnusedSize = std::max(1024, this->strings.size() * 2);
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QSet>
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+
+namespace chatterino {
+namespace util {
+
+// Keeps one copy of every interned string. Copies of a QString share their data, so a name that is
+// used in thousands of messages is only stored once.
+class StringInterner : boost::noncopyable
+{
+    StringInterner() = default;
+
+public:
+    static StringInterner &getInstance();
+
+    // returns a string equal to str that shares its data with the other interned strings
+    // can be called from any thread
+    QString intern(const QString &str);
+
+private:
+    // removes the strings that are only used by the interner
+    void removeUnused();
+
+    std::mutex mutex;
+    QSet<QString> strings;
+    int removeUnusedSize = 1024;
+};
+
+}  // namespace util
+}  // namespace chatterino
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QString>
+#include <QStringRef>
+
+namespace chatterino {
+namespace util {
+
+// Finds where the line has to be broken in a word that is too wide for it. fits(end) has to
+// return whether text[start, end) fits into the line. The end is found with a binary search, so
+// only O(log n) substrings have to be measured per line. Surrogate pairs are never split and at
+// least one character is returned so wrapping always makes progress.
+template <typename Fits>
+int findWrapEnd(const QStringRef &text, int start, Fits &&fits)
+{
+    int length = text.length();
+
+    // moves an index back if it points into the middle of a surrogate pair
+    auto toBoundary = [&text, length](int index) {
+        if (index > 0 && index < length && text.at(index).isLowSurrogate() &&
+            text.at(index - 1).isHighSurrogate()) {
+            return index - 1;
+        }
+        return index;
+    };
+
+    int minEnd = start + 1;
+    if (minEnd < length && text.at(start).isHighSurrogate() && text.at(minEnd).isLowSurrogate()) {
+        minEnd++;
+    }
+
+    if (minEnd >= length || fits(length)) {
+        return length;
+    }
+
+    // fits(low) is true or low is the minimum end, fits(high) is false
+    int low = minEnd;
+    int high = length;
+
+    while (high - low > 1) {
+        int middle = low + (high - low) / 2;
+        int end = toBoundary(middle);
+
+        if (end <= minEnd || fits(end)) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    int end = toBoundary(low);
+
+    return end < minEnd ? minEnd : end;
+}
+
+// Splits a word that is wider than a line into the parts that fill one line each. fits(text, end)
+// has to return whether text[0, end) fits into an empty line, addPart(part, isLastPart) is called
+// for every part in order. The parts point into the word, nothing is copied.
+template <typename Fits, typename AddPart>
+void wrapWord(const QStringRef &word, Fits &&fits, AddPart &&addPart)
+{
+    int wordStart = 0;
+
+    while (wordStart < word.length()) {
+        QStringRef rest = word.mid(wordStart);
+
+        int length = findWrapEnd(rest, 0, [&](int end) {
+            return fits(rest, end);  //
+        });
+
+        bool isLastPart = length == rest.length();
+
+        addPart(rest.left(length), isLastPart);
+
+        wordStart += length;
+    }
+}
+
+}  // namespace util
+}  // namespace chatterino
@@ -1,10 +1,12 @@
 #include "channelview.hpp"
 #include "debug/log.hpp"
 #include "messages/layouts/messagelayout.hpp"
+#include "messages/layouts/messagelayoutengine.hpp"
 #include "messages/limitedqueuesnapshot.hpp"
 #include "messages/message.hpp"
 #include "providers/twitch/twitchserver.hpp"
 #include "singletons/channelmanager.hpp"
+#include "singletons/scrollbackmanager.hpp"
 #include "singletons/settingsmanager.hpp"
 #include "singletons/thememanager.hpp"
 #include "singletons/windowmanager.hpp"
@@ -19,10 +21,12 @@
 #include <QDesktopServices>
 #include <QGraphicsBlurEffect>
 #include <QPainter>
+#include <QPointer>
 
 #include <math.h>
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 
@@ -38,9 +42,11 @@ ChannelView::ChannelView(BaseWidget *parent)
     : BaseWidget(parent)
     , scrollBar(this)
     , userPopupWidget(std::shared_ptr<TwitchChannel>())
+    , messages(singletons::ScrollbackManager::maxMessageLimit)
 {
 #ifndef Q_OS_MAC
-//    this->setAttribute(Qt::WA_OpaquePaintEvent);
+    // the background is always filled, Qt can only scroll the contents of opaque widgets
+    this->setAttribute(Qt::WA_OpaquePaintEvent);
 #endif
     this->setMouseTracking(true);
 
@@ -54,12 +60,13 @@ ChannelView::ChannelView(BaseWidget *parent)
         this->goToBottom->setVisible(this->enableScrollingToBottom && this->scrollBar.isVisible() &&
                                      !this->scrollBar.isAtBottom());
 
-        this->queueUpdate();
+        if (!this->scrollContent()) {
+            this->queueUpdate();
+        }
     });
 
     singletons::WindowManager &windowManager = singletons::WindowManager::getInstance();
 
-    this->repaintGifsConnection = windowManager.repaintGifs.connect([&] { this->queueUpdate(); });
     this->layoutConnection = windowManager.layout.connect([&](Channel *channel) {
         if (channel == nullptr || this->channel.get() == channel) {
             this->layoutMessages();
@@ -86,9 +93,10 @@ ChannelView::ChannelView(BaseWidget *parent)
     this->updateTimer.setInterval(1000 / 60);
     this->updateTimer.setSingleShot(true);
     connect(&this->updateTimer, &QTimer::timeout, this, [this] {
-        if (this->updateQueued) {
-            this->updateQueued = false;
-            this->repaint();
+        if (!this->queuedUpdate.isEmpty()) {
+            QRegion region = this->queuedUpdate;
+            this->queuedUpdate = QRegion();
+            this->repaint(region);
             this->updateTimer.start();
         }
     });
@@ -109,11 +117,13 @@ ChannelView::~ChannelView()
                         &singletons::SettingManager::wordFlagsChanged, this,
                         &ChannelView::wordFlagsChanged);
     this->messageAppendedConnection.disconnect();
-    this->messageRemovedConnection.disconnect();
-    this->repaintGifsConnection.disconnect();
     this->layoutConnection.disconnect();
     this->messageAddedAtStartConnection.disconnect();
     this->messageReplacedConnection.disconnect();
+
+    this->setCountedAsVisible(false);
+
+    AnimationScheduler::getInstance().removeWidget(this);
 }
 
 void ChannelView::themeRefreshEvent()
@@ -124,14 +134,19 @@ void ChannelView::themeRefreshEvent()
 }
 
 void ChannelView::queueUpdate()
+{
+    this->queueUpdate(this->rect());
+}
+
+void ChannelView::queueUpdate(const QRegion &region)
 {
     if (this->updateTimer.isActive()) {
-        this->updateQueued = true;
+        this->queuedUpdate += region;
         return;
     }
 
     //    this->repaint();
-    this->update();
+    this->update(region);
 
     this->updateTimer.start();
 }
@@ -166,17 +181,36 @@ void ChannelView::actuallyLayoutMessages()
     //        (this->scrollBar.isVisible() ? width() - this->scrollBar.width() : width()) - 4;
     int layoutWidth = LAYOUT_WIDTH;
 
-    MessageElement::Flags flags = this->getFlags();
+    MessageLayoutKey key =
+        MessageLayoutKey::current(layoutWidth, this->getScale(), this->getFlags());
+
+    // messages that were laid out before keep their old layout until the new one was computed
+    // on the worker threads, new messages are laid out right away so they have a height and
+    // rewrapping after a resize is cheap enough to do it right away as well
+    std::vector<MessageLayoutPtr> asyncLayouts;
+
+    auto layoutMessage = [&](const MessageLayoutPtr &message) {
+        if (!message->isLayoutRequired(key)) {
+            return false;
+        }
+
+        if (message->hasLayout() && !message->canRewrap(key)) {
+            asyncLayouts.push_back(message);
+            return false;
+        }
+
+        return message->layout(key);
+    };
 
     // layout the visible messages in the view
     if (messagesSnapshot.getLength() > start) {
         int y =
             -(messagesSnapshot[start]->getHeight() * (fmod(this->scrollBar.getCurrentValue(), 1)));
 
-        for (size_t i = start; i < messagesSnapshot.getLength(); ++i) {
-            auto message = messagesSnapshot[i];
+        for (auto it = messagesSnapshot.iteratorAt(start); it != messagesSnapshot.end(); ++it) {
+            const MessageLayoutPtr &message = *it;
 
-            redrawRequired |= message->layout(layoutWidth, this->getScale(), flags);
+            redrawRequired |= layoutMessage(message);
 
             y += message->getHeight();
 
@@ -186,19 +220,19 @@ void ChannelView::actuallyLayoutMessages()
         }
     }
 
-    // layout the messages at the bottom to determine the scrollbar thumb size
+    // estimate the heights of the messages at the bottom to determine the scrollbar thumb size,
+    // they only need a full layout once they are visible
     int h = height() - 8;
+    size_t count = 0;
 
-    for (int i = (int)messagesSnapshot.getLength() - 1; i >= 0; i--) {
-        auto *message = messagesSnapshot[i].get();
+    for (auto it = messagesSnapshot.rbegin(); it != messagesSnapshot.rend(); ++it) {
+        int messageHeight = (*it)->getEstimatedHeight(key);
 
-        message->layout(layoutWidth, this->getScale(), flags);
-
-        h -= message->getHeight();
+        h -= messageHeight;
+        count++;
 
         if (h < 0) {
-            this->scrollBar.setLargeChange((messagesSnapshot.getLength() - i) +
-                                           (qreal)h / message->getHeight());
+            this->scrollBar.setLargeChange(count + (qreal)h / messageHeight);
             //            this->scrollBar.setDesiredValue(this->scrollBar.getDesiredValue());
 
             showScrollbar = true;
@@ -226,6 +260,18 @@ void ChannelView::actuallyLayoutMessages()
         this->messageWasAdded = false;
     }
 
+    if (!asyncLayouts.empty()) {
+        QPointer<ChannelView> self(this);
+
+        MessageLayoutEngine::getInstance().layout(std::move(asyncLayouts), key, [self] {
+            if (self) {
+                // the heights changed, this also requests the layouts that were dropped again
+                self->layoutMessages();
+                self->queueUpdate();
+            }
+        });
+    }
+
     // MARK(timer);
 
     if (redrawRequired) {
@@ -319,30 +365,41 @@ void ChannelView::setChannel(ChannelPtr newChannel)
     }
     this->messages.clear();
 
-    // on new message
-    this->messageAppendedConnection =
-        newChannel->messageAppended.connect([this](MessagePtr &message) {
-            MessageLayoutPtr deleted;
+    bool countedAsVisible = this->countedAsVisible;
+    this->setCountedAsVisible(false);
 
-            auto messageRef = new MessageLayout(message);
+    // the snapshot below already contains the messages that weren't delivered yet
+    newChannel->flushAppendedMessages();
 
-            if (this->messages.pushBack(MessageLayoutPtr(messageRef), deleted)) {
-                if (!this->paused) {
-                    if (this->scrollBar.isAtBottom()) {
-                        this->scrollBar.scrollToBottom();
-                    } else {
-                        this->scrollBar.offset(-1);
-                    }
+    // the messages removed and added within a frame arrive together and are laid out once
+    this->messageAppendedConnection = newChannel->messagesAppended.connect(
+        [this](size_t removedAtStart, std::vector<MessagePtr> &messages) {
+            this->removeMessagesAtStart(removedAtStart);
+
+            bool highlighted = false;
+
+            for (const MessagePtr &message : messages) {
+                MessageLayoutPtr deleted;
+
+                // the limit of the view is at least as high as the one of the channel, the
+                // channel removes the messages at the start
+                this->messages.pushBack(MessageLayoutPtr(new MessageLayout(message)), deleted);
+
+                if (message->flags & ~Message::DoNotTriggerNotification) {
+                    highlighted = true;
                 }
+
+                this->scrollBar.addHighlight(message->getScrollBarHighlight());
             }
 
-            if (message->flags & ~Message::DoNotTriggerNotification) {
+            if (highlighted) {
                 this->highlightedMessageReceived.invoke();
             }
 
-            this->scrollBar.addHighlight(message->getScrollBarHighlight());
+            if (!messages.empty()) {
+                this->messageWasAdded = true;
+            }
 
-            this->messageWasAdded = true;
             this->layoutMessages();
         });
 
@@ -376,17 +433,6 @@ void ChannelView::setChannel(ChannelPtr newChannel)
             this->layoutMessages();
         });
 
-    // on message removed
-    this->messageRemovedConnection =
-        newChannel->messageRemovedFromStart.connect([this](MessagePtr &) {
-            this->selection.min.messageIndex--;
-            this->selection.max.messageIndex--;
-            this->selection.start.messageIndex--;
-            this->selection.end.messageIndex--;
-
-            this->layoutMessages();
-        });
-
     // on message replaced
     this->messageReplacedConnection =
         newChannel->messageReplaced.connect([this](size_t index, MessagePtr replacement) {
@@ -394,34 +440,83 @@ void ChannelView::setChannel(ChannelPtr newChannel)
 
             this->scrollBar.replaceHighlight(index, replacement->getScrollBarHighlight());
 
-            this->messages.replaceItem(this->messages.getSnapshot()[index], newItem);
+            this->messages.replaceItem(index, newItem);
             this->layoutMessages();
         });
 
     auto snapshot = newChannel->getMessageSnapshot();
 
-    for (size_t i = 0; i < snapshot.getLength(); i++) {
+    for (const MessagePtr &message : snapshot) {
         MessageLayoutPtr deleted;
 
-        auto messageRef = new MessageLayout(snapshot[i]);
+        auto messageRef = new MessageLayout(message);
 
         this->messages.pushBack(MessageLayoutPtr(messageRef), deleted);
     }
 
     this->channel = newChannel;
+    this->setCountedAsVisible(countedAsVisible);
 
     this->userPopupWidget.setChannel(newChannel);
     this->layoutMessages();
     this->queueUpdate();
 }
 
+void ChannelView::removeMessagesAtStart(size_t count)
+{
+    MessageLayoutPtr deleted;
+    size_t removed = 0;
+
+    while (removed < count && this->messages.popFront(deleted)) {
+        removed++;
+    }
+
+    if (removed > 0) {
+        this->scrollBar.removeHighlightsAtStart(removed);
+
+        if (!this->paused) {
+            if (this->scrollBar.isAtBottom()) {
+                this->scrollBar.scrollToBottom();
+            } else {
+                this->scrollBar.offset(-(qreal)removed);
+            }
+        }
+
+        // the part of the selection in the removed messages starts at the first message now, a
+        // selection that was completely removed ends up empty
+        auto shift = [removed](SelectionItem item) {
+            item.messageIndex -= (int)removed;
+
+            return item.messageIndex < 0 ? SelectionItem(0, 0) : item;
+        };
+
+        this->selection = Selection(shift(this->selection.start), shift(this->selection.end));
+    }
+}
+
 void ChannelView::detachChannel()
 {
-    // on message added
+    // the old channel must not add, insert or replace messages anymore
     this->messageAppendedConnection.disconnect();
+    this->messageAddedAtStartConnection.disconnect();
+    this->messageReplacedConnection.disconnect();
+}
 
-    // on message removed
-    this->messageRemovedConnection.disconnect();
+void ChannelView::setCountedAsVisible(bool value)
+{
+    if (this->countedAsVisible == value) {
+        return;
+    }
+
+    this->countedAsVisible = value;
+
+    if (this->channel) {
+        if (value) {
+            this->channel->addVisibleView();
+        } else {
+            this->channel->removeVisibleView();
+        }
+    }
 }
 
 void ChannelView::pause(int msecTimeout)
@@ -456,6 +551,20 @@ void ChannelView::resizeEvent(QResizeEvent *)
     this->update();
 }
 
+void ChannelView::showEvent(QShowEvent *)
+{
+    this->setCountedAsVisible(true);
+}
+
+void ChannelView::hideEvent(QHideEvent *)
+{
+    this->setCountedAsVisible(false);
+
+    // the gifs start again with the next paint
+    this->animations.clear();
+    AnimationScheduler::getInstance().removeWidget(this);
+}
+
 void ChannelView::setSelection(const SelectionItem &start, const SelectionItem &end)
 {
     // selections
@@ -486,52 +595,70 @@ messages::MessageElement::Flags ChannelView::getFlags() const
     return flags;
 }
 
-void ChannelView::paintEvent(QPaintEvent * /*event*/)
+void ChannelView::paintEvent(QPaintEvent *event)
 {
     //    BENCH(timer);
 
     QPainter painter(this);
 
-    painter.fillRect(rect(), this->themeManager.splits.background);
+    // only the damaged rect is painted, the rest of the widget stays as it is
+    painter.fillRect(event->rect(), this->themeManager.splits.background);
 
     // draw messages
-    this->drawMessages(painter);
+    this->drawMessages(painter, event->rect());
 
     //    MARK(timer);
 }
 
 // if overlays is false then it draws the message, if true then it draws things such as the grey
 // overlay when a message is disabled
-void ChannelView::drawMessages(QPainter &painter)
+void ChannelView::drawMessages(QPainter &painter, const QRect &clip)
 {
     auto messagesSnapshot = this->getMessagesSnapshot();
 
     size_t start = this->scrollBar.getCurrentValue();
 
+    this->animations.clear();
+    this->paintedTopMessage.reset();
+
     if (start >= messagesSnapshot.getLength()) {
+        AnimationScheduler::getInstance().removeWidget(this);
         return;
     }
 
     int y = -(messagesSnapshot[start].get()->getHeight() *
               (fmod(this->scrollBar.getCurrentValue(), 1)));
 
+    this->paintedTopMessage = messagesSnapshot[start];
+    this->paintedTopY = y;
+
     messages::MessageLayout *end = nullptr;
     bool windowFocused = this->window() == QApplication::activeWindow();
 
-    for (size_t i = start; i < messagesSnapshot.getLength(); ++i) {
-        messages::MessageLayout *layout = messagesSnapshot[i].get();
+    size_t i = start;
+    auto startIt = messagesSnapshot.iteratorAt(start);
+    auto endIt = startIt;
+
+    for (; endIt != messagesSnapshot.end(); ++endIt, ++i) {
+        messages::MessageLayout *layout = endIt->get();
 
         bool isLastMessage = false;
         if (singletons::SettingManager::getInstance().showLastMessageIndicator) {
             isLastMessage = this->lastReadMessage.get() == layout;
         }
 
-        layout->paint(painter, y, i, this->selection, isLastMessage, windowFocused);
+        // messages outside of the damaged rect keep their pixels
+        if (y + layout->getHeight() > clip.top() && y <= clip.bottom()) {
+            layout->paint(painter, y, i, this->selection, isLastMessage, windowFocused);
+        }
+
+        layout->addAnimations(this->animations, y);
 
         y += layout->getHeight();
 
         end = layout;
         if (y > height()) {
+            ++endIt;
             break;
         }
     }
@@ -540,13 +667,12 @@ void ChannelView::drawMessages(QPainter &painter)
         return;
     }
 
+    this->updateAnimations();
+
     // remove messages that are on screen
     // the messages that are left at the end get their buffers reset
-    for (size_t i = start; i < messagesSnapshot.getLength(); ++i) {
-        auto it = this->messagesOnScreen.find(messagesSnapshot[i]);
-        if (it != this->messagesOnScreen.end()) {
-            this->messagesOnScreen.erase(it);
-        }
+    for (auto it = startIt; it != endIt; ++it) {
+        this->messagesOnScreen.erase(*it);
     }
 
     // delete the message buffers that aren't on screen
@@ -557,15 +683,104 @@ void ChannelView::drawMessages(QPainter &painter)
     this->messagesOnScreen.clear();
 
     // add all messages on screen to the map
-    for (size_t i = start; i < messagesSnapshot.getLength(); ++i) {
-        std::shared_ptr<messages::MessageLayout> layout = messagesSnapshot[i];
+    for (auto it = startIt; it != endIt; ++it) {
+        this->messagesOnScreen.insert(*it);
+    }
+}
 
-        this->messagesOnScreen.insert(layout);
+QRect ChannelView::getMessageArea() const
+{
+    return QRect(0, 0, this->scrollBar.isVisible() ? this->scrollBar.x() : this->width(),
+                 this->height());
+}
+
+// moves the pixels of the last paint to the current scroll position, only the messages that
+// scrolled into view have to be painted then. returns false if a full repaint is required.
+bool ChannelView::scrollContent()
+{
+    if (!this->paintedTopMessage || !this->isVisible()) {
+        return false;
+    }
+
+    auto messagesSnapshot = this->getMessagesSnapshot();
 
-        if (layout.get() == end) {
+    size_t start = this->scrollBar.getCurrentValue();
+
+    if (start >= messagesSnapshot.getLength()) {
+        return false;
+    }
+
+    int y = -(messagesSnapshot[start]->getHeight() * (fmod(this->scrollBar.getCurrentValue(), 1)));
+
+    // find out where the message that was at the top is now
+    boost::optional<int> paintedTopY;
+
+    int top = y;
+    for (auto it = messagesSnapshot.iteratorAt(start);
+         it != messagesSnapshot.end() && top < this->height(); ++it) {
+        if (*it == this->paintedTopMessage) {
+            paintedTopY = top;
             break;
         }
+        top += (*it)->getHeight();
+    }
+
+    top = y;
+    for (size_t i = start; !paintedTopY && i > 0 && top > -this->height();) {
+        i--;
+        top -= messagesSnapshot[i]->getHeight();
+
+        if (messagesSnapshot[i] == this->paintedTopMessage) {
+            paintedTopY = top;
+        }
+    }
+
+    if (!paintedTopY) {
+        return false;
+    }
+
+    int delta = paintedTopY.get() - this->paintedTopY;
+
+    if (std::abs(delta) >= this->height()) {
+        return false;
+    }
+
+    if (delta != 0) {
+        QRect area = this->getMessageArea();
+
+        this->scroll(0, delta, area);
+
+        // damage that wasn't painted yet moves with the pixels
+        QRegion queued = this->queuedUpdate & area;
+        this->queuedUpdate -= area;
+        this->queuedUpdate += queued.translated(0, delta) & area;
+
+        for (VisibleAnimation &animation : this->animations) {
+            animation.rect.translate(0, delta);
+        }
+
+        this->updateAnimations();
     }
+
+    this->paintedTopMessage = messagesSnapshot[start];
+    this->paintedTopY = y;
+
+    return true;
+}
+
+// passes the gif emotes that are on screen to the AnimationScheduler
+void ChannelView::updateAnimations()
+{
+    QRect area = this->getMessageArea();
+
+    this->animations.erase(std::remove_if(this->animations.begin(), this->animations.end(),
+                                          [&](VisibleAnimation &animation) {
+                                              animation.rect &= area;
+                                              return animation.rect.isEmpty();
+                                          }),
+                           this->animations.end());
+
+    AnimationScheduler::getInstance().setVisibleAnimations(this, this->animations);
 }
 
 void ChannelView::wheelEvent(QWheelEvent *event)
@@ -580,6 +795,10 @@ void ChannelView::wheelEvent(QWheelEvent *event)
         int snapshotLength = (int)snapshot.getLength();
         int i = std::min((int)desired, snapshotLength);
 
+        // the messages that are scrolled over don't need a full layout
+        MessageLayoutKey key =
+            MessageLayoutKey::current(LAYOUT_WIDTH, this->getScale(), this->getFlags());
+
         if (delta > 0) {
             float scrollFactor = fmod(desired, 1);
             float currentScrollLeft = (int)(scrollFactor * snapshot[i]->getHeight());
@@ -596,9 +815,8 @@ void ChannelView::wheelEvent(QWheelEvent *event)
                 if (i == 0) {
                     desired = 0;
                 } else {
-                    snapshot[i - 1]->layout(LAYOUT_WIDTH, this->getScale(), this->getFlags());
                     scrollFactor = 1;
-                    currentScrollLeft = snapshot[i - 1]->getHeight();
+                    currentScrollLeft = snapshot[i - 1]->getEstimatedHeight(key);
                 }
             }
         } else {
@@ -618,10 +836,8 @@ void ChannelView::wheelEvent(QWheelEvent *event)
                 if (i == snapshotLength - 1) {
                     desired = snapshot.getLength();
                 } else {
-                    snapshot[i + 1]->layout(LAYOUT_WIDTH, this->getScale(), this->getFlags());
-
                     scrollFactor = 1;
-                    currentScrollLeft = snapshot[i + 1]->getHeight();
+                    currentScrollLeft = snapshot[i + 1]->getEstimatedHeight(key);
                 }
             }
         }
@@ -915,8 +1131,10 @@ bool ChannelView::tryGetMessageAt(QPoint p, std::shared_ptr<messages::MessageLay
 
     int y = -(messagesSnapshot[start]->getHeight() * (fmod(this->scrollBar.getCurrentValue(), 1)));
 
-    for (size_t i = start; i < messagesSnapshot.getLength(); ++i) {
-        auto message = messagesSnapshot[i];
+    size_t i = start;
+
+    for (auto it = messagesSnapshot.iteratorAt(start); it != messagesSnapshot.end(); ++it, ++i) {
+        const MessageLayoutPtr &message = *it;
 
         if (p.y() < y + message->getHeight()) {
             relativePos = QPoint(p.x(), p.y() - y);
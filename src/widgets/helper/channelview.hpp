@@ -2,6 +2,7 @@
 
 #include "channel.hpp"
 #include "messages/image.hpp"
+#include "messages/layouts/animationscheduler.hpp"
 #include "messages/layouts/messagelayout.hpp"
 #include "messages/limitedqueuesnapshot.hpp"
 #include "messages/messageelement.hpp"
@@ -12,6 +13,7 @@
 #include "widgets/scrollbar.hpp"
 
 #include <QPaintEvent>
+#include <QRegion>
 #include <QScroller>
 #include <QTimer>
 #include <QWheelEvent>
@@ -32,6 +34,7 @@ public:
     virtual ~ChannelView();
 
     void queueUpdate();
+    void queueUpdate(const QRegion &region);
     Scrollbar &getScrollBar();
     QString getSelectedText();
     bool hasSelection();
@@ -58,6 +61,8 @@ protected:
     virtual void themeRefreshEvent() override;
 
     virtual void resizeEvent(QResizeEvent *) override;
+    virtual void showEvent(QShowEvent *) override;
+    virtual void hideEvent(QHideEvent *) override;
 
     virtual void paintEvent(QPaintEvent *) override;
     virtual void wheelEvent(QWheelEvent *event) override;
@@ -78,7 +83,7 @@ protected:
 
 private:
     QTimer updateTimer;
-    bool updateQueued = false;
+    QRegion queuedUpdate;
     bool messageWasAdded = false;
     bool paused = false;
     QTimer pauseTimeout;
@@ -88,13 +93,21 @@ private:
     messages::LimitedQueueSnapshot<messages::MessageLayoutPtr> snapshot;
 
     void detachChannel();
+    void setCountedAsVisible(bool value);
     void actuallyLayoutMessages();
 
-    void drawMessages(QPainter &painter);
+    void drawMessages(QPainter &painter, const QRect &clip);
+    QRect getMessageArea() const;
+    bool scrollContent();
+    void updateAnimations();
     void setSelection(const messages::SelectionItem &start, const messages::SelectionItem &end);
+    // removes the layouts of messages the channel removed, doesn't lay out the view
+    void removeMessagesAtStart(size_t count);
     messages::MessageElement::Flags getFlags() const;
 
     ChannelPtr channel;
+    // whether this view is counted as a visible view of the channel
+    bool countedAsVisible = false;
 
     Scrollbar scrollBar;
     RippleEffectLabel *goToBottom;
@@ -118,15 +131,21 @@ private:
 
     boost::signals2::connection messageAppendedConnection;
     boost::signals2::connection messageAddedAtStartConnection;
-    boost::signals2::connection messageRemovedConnection;
     boost::signals2::connection messageReplacedConnection;
-    boost::signals2::connection repaintGifsConnection;
     boost::signals2::connection layoutConnection;
 
     std::vector<pajlada::Signals::ScopedConnection> managedConnections;
 
     std::unordered_set<std::shared_ptr<messages::MessageLayout>> messagesOnScreen;
 
+    // damage tracking
+    // the gif emotes on screen, they are repainted by the AnimationScheduler
+    std::vector<messages::layouts::VisibleAnimation> animations;
+    // the message at the top of the view and where it was drawn, used to scroll the pixels that
+    // are already drawn instead of painting every message again
+    messages::MessageLayoutPtr paintedTopMessage;
+    int paintedTopY = 0;
+
 private slots:
     void wordFlagsChanged()
     {
@@ -1,10 +1,15 @@
 #include "searchpopup.hpp"
 
+#include <QCheckBox>
 #include <QHBoxLayout>
 #include <QLineEdit>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
 #include "channel.hpp"
+#include "singletons/loggingmanager.hpp"
+#include "singletons/scrollbackmanager.hpp"
 #include "widgets/helper/channelview.hpp"
 
 namespace chatterino {
@@ -35,6 +40,15 @@ void SearchPopup::initLayout()
                                  [this] { this->performSearch(); });
             }
 
+            // SEARCH LOGS CHECKBOX
+            {
+                this->searchLogsCheckBox = new QCheckBox("Logs", this);
+                this->searchLogsCheckBox->setToolTip("Search the logs of all days");
+                layout2->addWidget(this->searchLogsCheckBox);
+                QObject::connect(this->searchLogsCheckBox, &QCheckBox::toggled,
+                                 [this] { this->performSearch(); });
+            }
+
             // SEARCH BUTTON
             {
                 QPushButton *searchButton = new QPushButton(this);
@@ -60,7 +74,7 @@ void SearchPopup::initLayout()
 
 void SearchPopup::setChannel(ChannelPtr channel)
 {
-    this->snapshot = channel->getMessageSnapshot();
+    this->channel = channel;
     this->performSearch();
 
     this->setWindowTitle("Searching in " + channel->name + "s history");
@@ -68,17 +82,31 @@ void SearchPopup::setChannel(ChannelPtr channel)
 
 void SearchPopup::performSearch()
 {
-    QString text = searchInput->text();
+    ChannelPtr sourceChannel = this->channel.lock();
 
-    ChannelPtr channel(new Channel("search"));
+    if (!sourceChannel) {
+        return;
+    }
 
-    for (size_t i = 0; i < this->snapshot.getLength(); i++) {
-        messages::MessagePtr message = this->snapshot[i];
+    // the results aren't searched again, indexing them would only cost time and memory
+    ChannelPtr channel(new Channel("search", false));
 
-        if (text.isEmpty() ||
-            message->searchText.indexOf(this->searchInput->text(), 0, Qt::CaseInsensitive) != -1) {
-            channel->addMessage(message);
-        }
+    if (this->searchLogsCheckBox->isChecked()) {
+        size_t maxResults = singletons::ScrollbackManager::maxMessageLimit;
+        channel->setMessageLimit(maxResults);
+
+        // the hits are added while the logs are searched, the search stops when the channel is
+        // replaced by the next search
+        singletons::LoggingManager::getInstance().searchLogs(
+            sourceChannel->name, this->searchInput->text(), channel, maxResults);
+    } else {
+        std::vector<messages::MessagePtr> results =
+            sourceChannel->search(this->searchInput->text());
+
+        channel->setMessageLimit(std::max<size_t>(results.size(), 1));
+
+        // adding them at the start doesn't log them again or add them to the recent chatters
+        channel->addMessagesAtStart(results);
     }
 
     this->channelView->setChannel(channel);
@@ -2,10 +2,10 @@
 
 #include <memory>
 
-#include "messages/limitedqueuesnapshot.hpp"
 #include "messages/message.hpp"
 #include "widgets/basewindow.hpp"
 
+class QCheckBox;
 class QLineEdit;
 namespace chatterino {
 class Channel;
@@ -20,8 +20,9 @@ public:
     void setChannel(std::shared_ptr<Channel> channel);
 
 private:
-    messages::LimitedQueueSnapshot<messages::MessagePtr> snapshot;
+    std::weak_ptr<Channel> channel;
     QLineEdit *searchInput;
+    QCheckBox *searchLogsCheckBox;
     ChannelView *channelView;
 
     void initLayout();
@@ -87,6 +87,7 @@ SplitHeader::SplitHeader(Split *_split)
 SplitHeader::~SplitHeader()
 {
     this->onlineStatusChangedConnection.disconnect();
+    this->firehoseChangedConnection.disconnect();
 }
 
 void SplitHeader::addDropdownItems(RippleEffectButton *label)
@@ -129,12 +130,17 @@ void SplitHeader::initializeChannelSignals()
 {
     // Disconnect any previous signal first
     this->onlineStatusChangedConnection.disconnect();
+    this->firehoseChangedConnection.disconnect();
 
     auto channel = this->split->getChannel();
     TwitchChannel *twitchChannel = dynamic_cast<TwitchChannel *>(channel.get());
 
     if (twitchChannel) {
-        twitchChannel->onlineStatusChanged.connect([this]() {
+        this->onlineStatusChangedConnection = twitchChannel->onlineStatusChanged.connect([this]() {
+            this->updateChannelText();  //
+        });
+
+        this->firehoseChangedConnection = twitchChannel->firehoseChanged.connect([this]() {
             this->updateChannelText();  //
         });
     }
@@ -178,6 +184,12 @@ void SplitHeader::updateChannelText()
             this->titleLabel->setText(channelName);
             this->tooltip = "";
         }
+
+        if (twitchChannel != nullptr && twitchChannel->isFirehoseMode()) {
+            this->titleLabel->setText(
+                this->titleLabel->text() + " (" +
+                QString::number(twitchChannel->getSkippedMessageCount()) + " skipped)");
+        }
     }
 }
 
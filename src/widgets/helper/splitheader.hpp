@@ -51,6 +51,7 @@ private:
     bool dragging = false;
 
     boost::signals2::connection onlineStatusChangedConnection;
+    boost::signals2::connection firehoseChangedConnection;
 
     RippleEffectButton *dropdownButton;
     //    Label *titleLabel;
@@ -1,4 +1,5 @@
 #include "widgets/scrollbar.hpp"
+#include "singletons/scrollbackmanager.hpp"
 #include "singletons/thememanager.hpp"
 #include "widgets/helper/channelview.hpp"
 
@@ -16,6 +17,7 @@ namespace widgets {
 Scrollbar::Scrollbar(ChannelView *parent)
     : BaseWidget(parent)
     , currentValueAnimation(this, "currentValue")
+    , highlights(singletons::ScrollbackManager::maxMessageLimit)
     , smoothScrollingSetting(singletons::SettingManager::getInstance().enableSmoothScrolling)
 {
     resize((int)(16 * this->getScale()), 100);
@@ -52,6 +54,17 @@ void Scrollbar::replaceHighlight(size_t index, ScrollbarHighlight replacement)
     this->highlights.replaceItem(index, replacement);
 }
 
+void Scrollbar::removeHighlightsAtStart(size_t count)
+{
+    ScrollbarHighlight deleted;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!this->highlights.popFront(deleted)) {
+            break;
+        }
+    }
+}
+
 void Scrollbar::scrollToBottom(bool animate)
 {
     this->setDesiredValue(this->maximum - this->getLargeChange(), animate);
@@ -229,8 +242,7 @@ void Scrollbar::paintEvent(QPaintEvent *)
     float dY = (float)(this->height()) / (float)snapshotLength;
     int highlightHeight = std::ceil(dY);
 
-    for (int i = 0; i < snapshotLength; i++) {
-        ScrollbarHighlight const &highlight = snapshot[i];
+    for (const ScrollbarHighlight &highlight : snapshot) {
 
         if (!highlight.isNull()) {
             if (highlight.getStyle() == ScrollbarHighlight::Default) {
@@ -26,6 +26,7 @@ public:
     void addHighlight(ScrollbarHighlight highlight);
     void addHighlightsAtStart(const std::vector<ScrollbarHighlight> &highlights);
     void replaceHighlight(size_t index, ScrollbarHighlight replacement);
+    void removeHighlightsAtStart(size_t count);
 
     void scrollToBottom(bool animate = false);
     bool isAtBottom() const;
@@ -11,6 +11,9 @@
 #define INPUT_EMPTY "Hide input box when empty"
 #define LAST_MSG "Show last read message indicator (marks the spot where you left the window)"
 #define PAUSE_HOVERING "When hovering"
+#define SCROLLBACK_MEMORY "Memory for messages (MB):"
+#define BUFFER_MEMORY "Memory for cached message images (MB):"
+#define FIREHOSE_RATE "Only show some messages above (messages/s, 0 = off):"
 
 #define STREAMLINK_QUALITY "Choose", "Source", "High", "Medium", "Low", "Audio only"
 
@@ -35,6 +38,9 @@ BehaviourPage::BehaviourPage()
         form->addRow("Mouse scroll speed:", this->createMouseScrollSlider());
         form->addRow("Links:", this->createCheckBox("Open links only on double click",
                                                     settings.linksDoubleClickOnly));
+        form->addRow(SCROLLBACK_MEMORY, this->createSpinBox(settings.scrollbackMemoryBudget, 16));
+        form->addRow(BUFFER_MEMORY, this->createSpinBox(settings.messageBufferMemory));
+        form->addRow(FIREHOSE_RATE, this->createSpinBox(settings.firehoseMessageRate));
     }
 
     layout->addSpacing(16);
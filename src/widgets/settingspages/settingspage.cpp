@@ -79,6 +79,23 @@ QLineEdit *SettingsPage::createLineEdit(pajlada::Settings::Setting<QString> &set
     return edit;
 }
 
+QSpinBox *SettingsPage::createSpinBox(pajlada::Settings::Setting<int> &setting, int min, int max)
+{
+    QSpinBox *spinBox = new QSpinBox();
+
+    spinBox->setMinimum(min);
+    spinBox->setMaximum(max);
+
+    // update when setting changes
+    setting.connect([spinBox](const int &value, auto) { spinBox->setValue(value); },
+                    this->managedConnections);
+
+    QObject::connect(spinBox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                     [&setting](int newValue) { setting = newValue; });
+
+    return spinBox;
+}
+
 }  // namespace settingspages
 }  // namespace widgets
 }  // namespace chatterino
@@ -3,6 +3,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLineEdit>
+#include <QSpinBox>
 #include <pajlada/signals/signal.hpp>
 
 #include "singletons/settingsmanager.hpp"
@@ -25,6 +26,7 @@ public:
     QComboBox *createComboBox(const QStringList &items,
                               pajlada::Settings::Setting<QString> &setting);
     QLineEdit *createLineEdit(pajlada::Settings::Setting<QString> &setting);
+    QSpinBox *createSpinBox(pajlada::Settings::Setting<int> &setting, int min = 0, int max = 2500);
 
 protected:
     QString name;
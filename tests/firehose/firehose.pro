@@ -0,0 +1,13 @@
+QT          += testlib
+QT          -= gui
+CONFIG      += c++14 console testcase
+CONFIG      -= app_bundle
+INCLUDEPATH += ../../src/
+TARGET       = tst_firehosefilter
+TEMPLATE     = app
+
+SOURCES += \
+    tst_firehosefilter.cpp
+
+HEADERS += \
+    ../../src/providers/twitch/firehosefilter.hpp
@@ -0,0 +1,145 @@
+#include "providers/twitch/firehosefilter.hpp"
+
+#include <QtTest>
+
+using namespace chatterino::providers::twitch;
+
+namespace {
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+// sends messages at the rate for the duration, returns how many were shown
+int sendMessages(FirehoseFilter &filter, TimePoint &time, int limit, int perSecond,
+                 std::chrono::milliseconds duration)
+{
+    std::chrono::milliseconds interval(1000 / perSecond);
+    TimePoint end = time + duration;
+    int shown = 0;
+
+    while (time < end) {
+        if (filter.addMessage(time, limit, false)) {
+            shown++;
+        }
+
+        time += interval;
+    }
+
+    return shown;
+}
+
+}  // namespace
+
+class FirehoseFilterTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void exitRate_data();
+    void exitRate();
+    void smallLimitsEndMode_data();
+    void smallLimitsEndMode();
+    void keepsModeAboveExitRate();
+    void noLimitShowsEverything();
+    void showsHighlights();
+};
+
+void FirehoseFilterTest::exitRate_data()
+{
+    QTest::addColumn<int>("limit");
+    QTest::addColumn<int>("exitRate");
+
+    QTest::newRow("1") << 1 << 1;
+    QTest::newRow("2") << 2 << 1;
+    QTest::newRow("3") << 3 << 2;
+    QTest::newRow("4") << 4 << 3;
+    QTest::newRow("100") << 100 << 75;
+}
+
+void FirehoseFilterTest::exitRate()
+{
+    QFETCH(int, limit);
+    QFETCH(int, exitRate);
+
+    QCOMPARE(FirehoseFilter::getExitRate(limit), exitRate);
+}
+
+void FirehoseFilterTest::smallLimitsEndMode_data()
+{
+    QTest::addColumn<int>("limit");
+
+    for (int limit = 1; limit <= 5; limit++) {
+        QTest::newRow(qPrintable(QString::number(limit))) << limit;
+    }
+}
+
+void FirehoseFilterTest::smallLimitsEndMode()
+{
+    QFETCH(int, limit);
+
+    FirehoseFilter filter;
+    TimePoint time;
+
+    // the mode starts once the rate is higher than the limit
+    for (int i = 0; i < limit; i++) {
+        filter.addMessage(time, limit, false);
+    }
+    QVERIFY(!filter.isActive());
+
+    filter.addMessage(time, limit, false);
+    QVERIFY(filter.isActive());
+
+    // a single message per second ends it, 3 / 4 of a limit of 1 used to be 0
+    time += std::chrono::milliseconds(1500);
+    QVERIFY(filter.addMessage(time, limit, false));
+    QCOMPARE(filter.getRate(), 1);
+    QVERIFY(!filter.isActive());
+
+    time += std::chrono::milliseconds(1500);
+    QVERIFY(filter.addMessage(time, limit, false));
+    QVERIFY(!filter.isActive());
+}
+
+void FirehoseFilterTest::keepsModeAboveExitRate()
+{
+    FirehoseFilter filter;
+    TimePoint time;
+
+    // 11 messages within a second are more than the limit
+    sendMessages(filter, time, 8, 10, std::chrono::seconds(2));
+    QVERIFY(filter.isActive());
+
+    // 8 messages within a second are between the exit rate of 6 and the limit
+    sendMessages(filter, time, 8, 7, std::chrono::seconds(2));
+    QVERIFY(filter.isActive());
+
+    // 6 messages within a second end the mode
+    sendMessages(filter, time, 8, 5, std::chrono::seconds(2));
+    QVERIFY(!filter.isActive());
+}
+
+void FirehoseFilterTest::noLimitShowsEverything()
+{
+    FirehoseFilter filter;
+    TimePoint time;
+
+    QCOMPARE(sendMessages(filter, time, 0, 500, std::chrono::seconds(2)), 1000);
+    QVERIFY(!filter.isActive());
+}
+
+void FirehoseFilterTest::showsHighlights()
+{
+    FirehoseFilter filter;
+    TimePoint time;
+
+    int shown = sendMessages(filter, time, 10, 500, std::chrono::seconds(2));
+    QVERIFY(filter.isActive());
+
+    // about as many messages as the limit allows are shown, a few more while the rate rises
+    QVERIFY(shown < 100);
+
+    QVERIFY(filter.addMessage(time, 10, true));
+}
+
+QTEST_APPLESS_MAIN(FirehoseFilterTest)
+
+#include "tst_firehosefilter.moc"
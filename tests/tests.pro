@@ -0,0 +1,10 @@
+# Tests and benchmarks of the parts that don't need the rest of the application
+#
+#   qmake tests/tests.pro && make && make check
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    firehose \
+    twitchtags \
+    wordwrap
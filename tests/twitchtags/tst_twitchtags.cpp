@@ -0,0 +1,349 @@
+#include "providers/twitch/twitchtags.hpp"
+
+#include <QFile>
+#include <QStringList>
+#include <QVariantMap>
+#include <QtTest>
+
+#include <string>
+
+using namespace chatterino::providers::twitch;
+
+Q_DECLARE_METATYPE(std::vector<TwitchEmoteOccurence>)
+
+namespace {
+
+QByteArray createLine(const QByteArray &tags)
+{
+    return "@" + tags + " :nick!nick@nick.tmi.twitch.tv PRIVMSG #channel :Kappa 123";
+}
+
+// the lines of tests/twitchtags/lines.txt, another file can be used with TWITCH_LINES
+QList<QByteArray> loadLines()
+{
+    QByteArray path = qgetenv("TWITCH_LINES");
+    QFile file(path.isEmpty() ? QString(":/lines.txt") : QString::fromLocal8Bit(path));
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QList<QByteArray>();
+    }
+
+    QList<QByteArray> lines;
+
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (!line.isEmpty()) {
+            lines.append(line);
+        }
+    }
+
+    return lines;
+}
+
+QString unescapeLikeCommuni(const QString &value)
+{
+    QString unescaped;
+    unescaped.reserve(value.size());
+
+    for (int i = 0; i < value.size(); i++) {
+        if (value[i] != '\\') {
+            unescaped += value[i];
+        } else if (++i < value.size()) {
+            switch (value[i].unicode()) {
+                case ':':
+                    unescaped += ';';
+                    break;
+                case 's':
+                    unescaped += ' ';
+                    break;
+                case 'r':
+                    unescaped += '\r';
+                    break;
+                case 'n':
+                    unescaped += '\n';
+                    break;
+                default:
+                    unescaped += value[i];
+                    break;
+            }
+        }
+    }
+
+    return unescaped;
+}
+
+// the tags like Communi::IrcMessage::tags parses them, a QVariantMap of unescaped QStrings
+QVariantMap parseTagsLikeCommuni(const QByteArray &line)
+{
+    QVariantMap tags;
+
+    if (!line.startsWith('@')) {
+        return tags;
+    }
+
+    int space = line.indexOf(' ');
+    QString tagString = QString::fromUtf8(line.mid(1, space < 0 ? -1 : space - 1));
+
+    for (const QString &tag : tagString.split(';')) {
+        int equals = tag.indexOf('=');
+        QString value = equals < 0 ? QString() : unescapeLikeCommuni(tag.mid(equals + 1));
+
+        tags.insert(equals < 0 ? tag : tag.left(equals), value);
+    }
+
+    return tags;
+}
+
+// the "emotes" tag like TwitchMessageBuilder parsed it before TwitchTags
+std::vector<TwitchEmoteOccurence> parseEmotesLikeBefore(const QString &emotes)
+{
+    std::vector<TwitchEmoteOccurence> occurences;
+
+    for (const QString &emote : emotes.split('/')) {
+        QStringList parameters = emote.split(':');
+
+        if (parameters.length() < 2) {
+            continue;
+        }
+
+        long int id = std::stol(parameters.at(0).toStdString(), nullptr, 10);
+
+        for (const QString &occurence : parameters.at(1).split(',')) {
+            QStringList coords = occurence.split('-');
+
+            if (coords.length() < 2) {
+                break;
+            }
+
+            long int start = std::stol(coords.at(0).toStdString(), nullptr, 10);
+            long int end = std::stol(coords.at(1).toStdString(), nullptr, 10);
+
+            occurences.push_back({id, (int)start, (int)end});
+        }
+    }
+
+    return occurences;
+}
+
+// the tags TwitchMessageBuilder reads from every message
+const char *const READ_TAGS[] = {"id", "room-id", "display-name", "color", "bits", "user-type"};
+
+}  // namespace
+
+class TwitchTagsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unescapesValues_data();
+    void unescapesValues();
+    void missingValues();
+    void linesWithoutTags();
+    void parsesEmotes_data();
+    void parsesEmotes();
+    void matchesCommuni();
+    void benchmarkTwitchTags();
+    void benchmarkCommuniTags();
+};
+
+void TwitchTagsTest::unescapesValues_data()
+{
+    QTest::addColumn<QByteArray>("value");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("plain") << QByteArray("abc") << "abc";
+    QTest::newRow("space") << QByteArray("a\\sb\\s") << "a b ";
+    QTest::newRow("semicolon") << QByteArray("a\\:b") << "a;b";
+    QTest::newRow("backslash") << QByteArray("a\\\\b") << "a\\b";
+    QTest::newRow("escaped escape") << QByteArray("\\\\s") << "\\s";
+    QTest::newRow("line breaks") << QByteArray("a\\r\\nb") << "a\r\nb";
+    QTest::newRow("unknown escape") << QByteArray("a\\qb") << "aqb";
+    QTest::newRow("trailing backslash") << QByteArray("abc\\") << "abc";
+    QTest::newRow("only a backslash") << QByteArray("\\") << "";
+    QTest::newRow("utf-8") << QByteArray("\xed\x95\x9c\\s\xeb\xb3\x84") << QString::fromUtf8("한 별");
+}
+
+void TwitchTagsTest::unescapesValues()
+{
+    QFETCH(QByteArray, value);
+    QFETCH(QString, expected);
+
+    QByteArray line = createLine("a=1;key=" + value + ";b=2");
+    TwitchTags tags(line);
+
+    QCOMPARE(tags.get("key").toString(), expected);
+    QCOMPARE(tags.get("a").toString(), QString("1"));
+    QCOMPARE(tags.get("b").toString(), QString("2"));
+}
+
+void TwitchTagsTest::missingValues()
+{
+    QByteArray line = createLine("flag;empty=;color=#FF0000;user-type=");
+    TwitchTags tags(line);
+
+    // a tag without a value exists, but is empty
+    QVERIFY(tags.contains("flag"));
+    QVERIFY(!tags.get("flag").isNull());
+    QVERIFY(tags.get("flag").isEmpty());
+
+    QVERIFY(tags.contains("empty"));
+    QVERIFY(tags.get("empty").isEmpty());
+    QCOMPARE(tags.get("empty").toString(), QString());
+
+    QVERIFY(tags.get("user-type").isEmpty());
+    QCOMPARE(tags.get("color").toString(), QString("#FF0000"));
+
+    QVERIFY(!tags.contains("bits"));
+    QVERIFY(tags.get("bits").isNull());
+    QCOMPARE(tags.get("bits").toNumber(), Q_INT64_C(-1));
+
+    // keys have to match completely
+    QVERIFY(!tags.contains("colo"));
+    QVERIFY(!tags.contains("color="));
+}
+
+void TwitchTagsTest::linesWithoutTags()
+{
+    QByteArray line = ":nick!nick@nick.tmi.twitch.tv PRIVMSG #channel :color=#FF0000";
+    QVERIFY(!TwitchTags(line).contains("color"));
+
+    QByteArray empty;
+    QVERIFY(!TwitchTags(empty).contains("color"));
+
+    // the message after the tags isn't parsed
+    QByteArray tagged = createLine("a=1") + " b=2";
+    QVERIFY(!TwitchTags(tagged).contains("b"));
+}
+
+void TwitchTagsTest::parsesEmotes_data()
+{
+    QTest::addColumn<QByteArray>("emotes");
+    QTest::addColumn<std::vector<TwitchEmoteOccurence>>("expected");
+
+    QTest::newRow("empty") << QByteArray() << std::vector<TwitchEmoteOccurence>{};
+    QTest::newRow("single") << QByteArray("25:0-4")
+                            << std::vector<TwitchEmoteOccurence>{{25, 0, 4}};
+    QTest::newRow("multiple") << QByteArray("25:0-4,12-16/1902:6-10")
+                              << std::vector<TwitchEmoteOccurence>{
+                                     {25, 0, 4}, {25, 12, 16}, {1902, 6, 10}};
+
+    // malformed parts are left out, the rest is kept
+    QTest::newRow("no colon") << QByteArray("25/1902:6-10")
+                              << std::vector<TwitchEmoteOccurence>{{1902, 6, 10}};
+    QTest::newRow("no ranges") << QByteArray("25:") << std::vector<TwitchEmoteOccurence>{};
+    QTest::newRow("no dash") << QByteArray("25:0-4,6,12-16")
+                             << std::vector<TwitchEmoteOccurence>{{25, 0, 4}, {25, 12, 16}};
+    QTest::newRow("no start") << QByteArray("25:-4") << std::vector<TwitchEmoteOccurence>{};
+    QTest::newRow("no end") << QByteArray("25:0-") << std::vector<TwitchEmoteOccurence>{};
+    QTest::newRow("negative") << QByteArray("25:-1-4") << std::vector<TwitchEmoteOccurence>{};
+    QTest::newRow("letters") << QByteArray("abc:0-4/25:x-4,0-4y,6-10")
+                             << std::vector<TwitchEmoteOccurence>{{25, 6, 10}};
+    QTest::newRow("overflow") << QByteArray("25:0-99999999999,0-4/99999999999999999999:0-4")
+                              << std::vector<TwitchEmoteOccurence>{{25, 0, 4}};
+    QTest::newRow("empty parts") << QByteArray("/25:0-4,,6-10/")
+                                 << std::vector<TwitchEmoteOccurence>{{25, 0, 4}, {25, 6, 10}};
+
+    // the builder checks the ranges against the message
+    QTest::newRow("reversed") << QByteArray("25:4-0")
+                              << std::vector<TwitchEmoteOccurence>{{25, 4, 0}};
+}
+
+void TwitchTagsTest::parsesEmotes()
+{
+    QFETCH(QByteArray, emotes);
+    QFETCH(std::vector<TwitchEmoteOccurence>, expected);
+
+    QByteArray line = createLine("badges=;emotes=" + emotes + ";id=1");
+    auto occurences = parseTwitchEmotes(TwitchTags(line).get("emotes"));
+
+    QCOMPARE(occurences.size(), expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        QCOMPARE(occurences[i].id, expected[i].id);
+        QCOMPARE(occurences[i].start, expected[i].start);
+        QCOMPARE(occurences[i].end, expected[i].end);
+    }
+}
+
+void TwitchTagsTest::matchesCommuni()
+{
+    QList<QByteArray> lines = loadLines();
+    QVERIFY(!lines.isEmpty());
+
+    for (const QByteArray &line : lines) {
+        TwitchTags tags(line);
+        QVariantMap expected = parseTagsLikeCommuni(line);
+
+        for (auto it = expected.begin(); it != expected.end(); ++it) {
+            QByteArray key = it.key().toUtf8();
+
+            QVERIFY(tags.contains(key.constData()));
+            QCOMPARE(tags.get(key.constData()).toString(), it.value().toString());
+        }
+
+        auto occurences = parseTwitchEmotes(tags.get("emotes"));
+        auto expectedOccurences = parseEmotesLikeBefore(expected.value("emotes").toString());
+
+        QCOMPARE(occurences.size(), expectedOccurences.size());
+
+        for (size_t i = 0; i < occurences.size(); i++) {
+            QCOMPARE(occurences[i].id, expectedOccurences[i].id);
+            QCOMPARE(occurences[i].start, expectedOccurences[i].start);
+            QCOMPARE(occurences[i].end, expectedOccurences[i].end);
+        }
+    }
+}
+
+// reads the tags TwitchMessageBuilder reads from every line
+void TwitchTagsTest::benchmarkTwitchTags()
+{
+    QList<QByteArray> lines = loadLines();
+    QVERIFY(!lines.isEmpty());
+
+    int count = 0;
+
+    QBENCHMARK {
+        for (const QByteArray &line : lines) {
+            TwitchTags tags(line);
+
+            for (const char *key : READ_TAGS) {
+                count += tags.get(key).toString().size();
+            }
+
+            count += (int)splitTagRef(tags.get("badges"), ',').size();
+            count += (int)parseTwitchEmotes(tags.get("emotes")).size();
+        }
+    }
+
+    QVERIFY(count > 0);
+}
+
+void TwitchTagsTest::benchmarkCommuniTags()
+{
+    QList<QByteArray> lines = loadLines();
+    QVERIFY(!lines.isEmpty());
+
+    int count = 0;
+
+    QBENCHMARK {
+        for (const QByteArray &line : lines) {
+            QVariantMap tags = parseTagsLikeCommuni(line);
+
+            for (const char *key : READ_TAGS) {
+                auto it = tags.find(key);
+
+                if (it != tags.end()) {
+                    count += it.value().toString().size();
+                }
+            }
+
+            count += tags.value("badges").toString().split(',').size();
+            count += (int)parseEmotesLikeBefore(tags.value("emotes").toString()).size();
+        }
+    }
+
+    QVERIFY(count > 0);
+}
+
+QTEST_APPLESS_MAIN(TwitchTagsTest)
+
+#include "tst_twitchtags.moc"
@@ -0,0 +1,17 @@
+QT          += testlib
+QT          -= gui
+CONFIG      += c++14 console testcase
+CONFIG      -= app_bundle
+INCLUDEPATH += ../../src/
+TARGET       = tst_twitchtags
+TEMPLATE     = app
+
+SOURCES += \
+    tst_twitchtags.cpp \
+    ../../src/providers/twitch/twitchtags.cpp
+
+HEADERS += \
+    ../../src/providers/twitch/twitchtags.hpp
+
+RESOURCES += \
+    twitchtags.qrc
@@ -0,0 +1,244 @@
+#include "util/wordwrap.hpp"
+
+#include <QFontMetrics>
+#include <QGuiApplication>
+#include <QStringList>
+#include <QtTest>
+
+#include <functional>
+#include <random>
+
+using namespace chatterino;
+
+namespace {
+
+// width of the character at the index, the low half of a surrogate pair is 0 wide
+typedef std::function<int(const QString &text, int index)> CharacterWidth;
+// width of text[0, end)
+typedef std::function<int(const QString &text, int end)> TextWidth;
+
+// a fake font, every character has its own width and emojis are wider than the rest
+int getCharacterWidth(const QString &text, int index)
+{
+    if (text[index].isLowSurrogate() && index > 0 && text[index - 1].isHighSurrogate()) {
+        return 0;
+    }
+
+    if (text[index].isHighSurrogate()) {
+        return 14;
+    }
+
+    return 4 + text[index].unicode() % 9;
+}
+
+int getWidth(const QString &text, int end)
+{
+    int width = 0;
+
+    for (int i = 0; i < end; i++) {
+        width += getCharacterWidth(text, i);
+    }
+
+    return width;
+}
+
+// wraps the word like TextElement did before util::wrapWord, one character is measured at a time
+QStringList wrapPerCharacter(const QString &word, int lineWidth,
+                             const CharacterWidth &characterWidth = getCharacterWidth)
+{
+    QStringList parts;
+    int start = 0;
+
+    while (start < word.length()) {
+        int width = 0;
+        int end = start;
+
+        while (end < word.length()) {
+            int next = end + 1;
+
+            if (word[end].isHighSurrogate() && next < word.length() &&
+                word[next].isLowSurrogate()) {
+                next++;
+            }
+
+            int widthOfCharacter = characterWidth(word, end);
+
+            // the first character of a line is always added
+            if (end > start && width + widthOfCharacter > lineWidth) {
+                break;
+            }
+
+            width += widthOfCharacter;
+            end = next;
+        }
+
+        parts.append(word.mid(start, end - start));
+        start = end;
+    }
+
+    return parts;
+}
+
+QStringList wrapBinarySearch(const QString &word, int lineWidth,
+                             const TextWidth &textWidth = getWidth)
+{
+    QStringList parts;
+
+    util::wrapWord(QStringRef(&word),
+                   [&](const QStringRef &text, int end) {
+                       // measured in place like TextElement does
+                       QString raw = QString::fromRawData(text.unicode(), text.size());
+                       return textWidth(raw, end) <= lineWidth;
+                   },
+                   [&parts](const QStringRef &part, bool) {
+                       parts.append(part.toString());  //
+                   });
+
+    return parts;
+}
+
+// copy pasta without spaces, a mix of latin, cjk and emojis
+QString createCopyPasta(std::mt19937 &random, int length)
+{
+    QString text;
+
+    while (text.length() < length) {
+        switch (random() % 6) {
+            case 0:
+                text += QString::fromUcs4(
+                    std::vector<uint>{0x1F600 + (uint)(random() % 80)}.data(), 1);
+                break;
+            case 1:
+                text += QChar(0x4E00 + (ushort)(random() % 500));
+                break;
+            default:
+                text += QChar('A' + (ushort)(random() % 58));
+                break;
+        }
+    }
+
+    return text;
+}
+
+}  // namespace
+
+class WordWrapTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesPerCharacterLoop();
+    void splitsLongWords();
+    void partsPointIntoWord();
+    void benchmarkPerCharacter();
+    void benchmarkBinarySearch();
+};
+
+void WordWrapTest::matchesPerCharacterLoop()
+{
+    std::mt19937 random(1337);
+
+    for (int i = 0; i < 500; i++) {
+        QString word = createCopyPasta(random, 500 + (int)(random() % 1500));
+
+        // narrower than a single character, exactly as wide as an emoji and regular widths
+        for (int lineWidth : {1, 14, 20 + (int)(random() % 400)}) {
+            QStringList parts = wrapBinarySearch(word, lineWidth);
+
+            QCOMPARE(parts, wrapPerCharacter(word, lineWidth));
+            QCOMPARE(parts.join(QString()), word);
+
+            for (const QString &part : parts) {
+                QVERIFY(!part.isEmpty());
+                QVERIFY(!part[0].isLowSurrogate());
+                QVERIFY(!part[part.length() - 1].isHighSurrogate());
+            }
+        }
+    }
+}
+
+void WordWrapTest::splitsLongWords()
+{
+    QString word(3000, 'W');
+
+    // 'W' is 4 + 87 % 9 = 10 wide
+    QStringList parts = wrapBinarySearch(word, 100);
+
+    QCOMPARE(parts.size(), 300);
+    QCOMPARE(parts.first(), QString(10, 'W'));
+    QCOMPARE(parts, wrapPerCharacter(word, 100));
+}
+
+void WordWrapTest::partsPointIntoWord()
+{
+    QString text = "abc " + QString(300, 'W') + " def";
+    QStringRef word(&text, 4, 300);
+    int position = word.position();
+    int lastParts = 0;
+
+    util::wrapWord(word,
+                   [](const QStringRef &rest, int end) {
+                       return getWidth(rest.toString(), end) <= 100;  //
+                   },
+                   [&](const QStringRef &part, bool isLastPart) {
+                       QVERIFY(part.string() == &text);
+                       QCOMPARE(part.position(), position);
+                       QCOMPARE(part.size(), 10);
+
+                       position += part.size();
+                       lastParts += isLastPart ? 1 : 0;
+                   });
+
+    QCOMPARE(position, 304);
+    QCOMPARE(lastParts, 1);
+}
+
+// the benchmarks measure with a real font, like TextElement does
+void WordWrapTest::benchmarkPerCharacter()
+{
+    std::mt19937 random(42);
+    QString word = createCopyPasta(random, 2000);
+    QFontMetrics metrics(QFont("Segoe UI", 10));
+
+    QBENCHMARK {
+        wrapPerCharacter(word, 300, [&metrics](const QString &text, int index) {
+            if (text[index].isLowSurrogate() && index > 0 && text[index - 1].isHighSurrogate()) {
+                return 0;
+            }
+
+            if (text[index].isHighSurrogate()) {
+                return metrics.width(text.mid(index, 2));
+            }
+
+            return metrics.width(text[index]);
+        });
+    }
+}
+
+void WordWrapTest::benchmarkBinarySearch()
+{
+    std::mt19937 random(42);
+    QString word = createCopyPasta(random, 2000);
+    QFontMetrics metrics(QFont("Segoe UI", 10));
+
+    QBENCHMARK {
+        wrapBinarySearch(word, 300, [&metrics](const QString &text, int end) {
+            return metrics.width(text, end);  //
+        });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // fonts need a gui application, but no display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    WordWrapTest test;
+
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_wordwrap.moc"
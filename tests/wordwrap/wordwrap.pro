@@ -0,0 +1,12 @@
+QT          += testlib gui
+CONFIG      += c++14 console testcase
+CONFIG      -= app_bundle
+INCLUDEPATH += ../../src/
+TARGET       = tst_wordwrap
+TEMPLATE     = app
+
+SOURCES += \
+    tst_wordwrap.cpp
+
+HEADERS += \
+    ../../src/util/wordwrap.hpp